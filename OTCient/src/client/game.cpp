@@ -112,11 +112,39 @@ void Game::processDisconnect()
         processGameEnd();
 
     if (m_protocolGame) {
+        if (m_protocolGame->isOpcodeProfiling())
+            processRecordBenchmarkEnd();
+
         m_protocolGame->disconnect();
         m_protocolGame = nullptr;
     }
 }
 
+void Game::processRecordBenchmarkEnd()
+{
+    const ticks_t elapsed = std::max<ticks_t>(m_recordBenchmarkTimer.elapsed_micros(), 1);
+    const uint32_t packets = m_protocolGame->getParsedMessages();
+    g_logger.info("Record benchmark: {} packets in {:.3f}s ({:.0f} packets/sec)", packets, elapsed / 1000000.0, packets * 1000000.0 / elapsed);
+
+    const auto& stats = m_protocolGame->getOpcodeStats();
+    std::vector<int> opcodes;
+    for (int opcode = 0; opcode < static_cast<int>(stats.size()); ++opcode) {
+        if (stats[opcode].count > 0)
+            opcodes.emplace_back(opcode);
+    }
+
+    std::sort(opcodes.begin(), opcodes.end(), [&stats](const int a, const int b) {
+        return stats[a].micros > stats[b].micros;
+    });
+
+    for (const int opcode : opcodes) {
+        const auto& opcodeStats = stats[opcode];
+        g_logger.info("  opcode 0x{:02X}: {} parsed, {} us total, {:.2f} us each", opcode, opcodeStats.count, opcodeStats.micros, static_cast<double>(opcodeStats.micros) / opcodeStats.count);
+    }
+
+    g_lua.callGlobalField("g_game", "onRecordBenchmarkEnd", packets, elapsed);
+}
+
 void Game::processUpdateNeeded(const std::string_view signature)
 {
     g_lua.callGlobalField("g_game", "onUpdateNeeded", signature);
@@ -617,7 +645,7 @@ void Game::loginWorld(const std::string_view account, const std::string_view pas
     m_worldName = worldName;
 }
 
-void Game::playRecord(const std::string_view& file)
+void Game::playRecord(const std::string_view& file, const bool benchmark)
 {
     if (m_protocolGame || isOnline())
         throw Exception("Unable to login into a world while already online or logging.");
@@ -635,7 +663,12 @@ void Game::playRecord(const std::string_view& file)
     m_localPlayer = std::make_shared<LocalPlayer>();
     m_localPlayer->setName("Player");
 
+    // a benchmark replays the record as fast as it can be parsed and profiles every opcode
+    packetPlayer->setFastForward(benchmark);
+
     m_protocolGame = std::make_shared<ProtocolGame>();
+    m_protocolGame->setOpcodeProfiling(benchmark);
+    m_recordBenchmarkTimer.restart();
     m_protocolGame->playRecord(packetPlayer);
     m_characterName = "Player";
     m_worldName = "Record";
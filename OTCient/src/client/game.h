@@ -463,6 +463,7 @@ private:
 protected:
     void processConnectionError(const std::error_code& ec);
     void processDisconnect();
+    void processRecordBenchmarkEnd();
     void processPing();
     void processPingBack();
 
@@ -584,7 +585,7 @@ protected:
 public:
     // login related
     void loginWorld(std::string_view account, std::string_view password, std::string_view worldName, std::string_view worldHost, int worldPort, std::string_view characterName, std::string_view authenticatorToken, std::string_view sessionKey, const std::string_view& recordTo);
-    void playRecord(const std::string_view& file);
+    void playRecord(const std::string_view& file, bool benchmark);
     void cancelLogin();
     void forceLogout();
     void safeLogout();
@@ -905,6 +906,7 @@ private:
     stdext::map<int, ContainerPtr> m_containers;
     stdext::map<int, Vip> m_vips;
     stdext::timer m_pingTimer;
+    stdext::timer m_recordBenchmarkTimer;
 
     ticks_t m_ping{ -1 };
 };
@@ -44,6 +44,86 @@
 
 const static TilePtr m_nulltile;
 
+TileBlock& TileBlockGrid::getOrCreate(const Position& pos)
+{
+    if (const auto block = find(pos))
+        return *block;
+
+    // claim the grid slot if it is free, otherwise the block lives in the sparse map
+    auto& slot = m_slots[getSlotIndex(pos)];
+    if (!slot.block) {
+        slot.index = getBlockIndex(pos);
+        slot.block = std::make_unique<TileBlock>();
+        return *slot.block;
+    }
+
+    auto& block = m_blocks[getBlockIndex(pos)];
+    block = std::make_unique<TileBlock>();
+    return *block;
+}
+
+void TileBlockGrid::recenter(const Position& centralPosition)
+{
+    const uint32_t centralBlock = getBlockIndex(centralPosition);
+    if (centralBlock == m_centralBlock)
+        return;
+
+    m_centralBlock = centralBlock;
+
+    const int centralX = centralPosition.x / BLOCK_SIZE;
+    const int centralY = centralPosition.y / BLOCK_SIZE;
+    constexpr int half = GRID_SIZE / 2;
+
+    for (int blockY = std::max<int>(centralY - half, 0); blockY < std::min<int>(centralY + half, BLOCKS_PER_SIDE); ++blockY) {
+        for (int blockX = std::max<int>(centralX - half, 0); blockX < std::min<int>(centralX + half, BLOCKS_PER_SIDE); ++blockX) {
+            const uint32_t index = getBlockIndex(blockX, blockY);
+            auto& slot = m_slots[getSlotIndex(blockX, blockY)];
+            if (slot.index == index)
+                continue;
+
+            // the block in this slot is out of the grid now
+            if (slot.block)
+                m_blocks.emplace(slot.index, std::move(slot.block));
+
+            slot.index = INVALID_INDEX;
+
+            if (const auto it = m_blocks.find(index); it != m_blocks.end()) {
+                slot.index = index;
+                slot.block = std::move(it->second);
+                m_blocks.erase(it);
+            }
+        }
+    }
+}
+
+void TileBlockGrid::eraseIf(const std::function<bool(TileBlock&)>& eraseBlock)
+{
+    for (auto& slot : m_slots) {
+        if (slot.block && eraseBlock(*slot.block)) {
+            slot.index = INVALID_INDEX;
+            slot.block = nullptr;
+        }
+    }
+
+    for (auto it = m_blocks.begin(); it != m_blocks.end();) {
+        if (eraseBlock(*it->second))
+            it = m_blocks.erase(it);
+        else
+            ++it;
+    }
+}
+
+void TileBlockGrid::clear()
+{
+    for (auto& slot : m_slots) {
+        slot.index = INVALID_INDEX;
+        slot.block = nullptr;
+    }
+
+    m_blocks.clear();
+    m_centralBlock = INVALID_INDEX;
+}
+
 Map g_map;
 
 void Map::init()
@@ -336,8 +416,8 @@ StaticTextPtr Map::getStaticText(const Position& pos) const
     return nullptr;
 }
 
-const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].create(pos) : m_nulltile; }
-const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks[getBlockIndex(pos)].getOrCreate(pos) : m_nulltile; }
+const TilePtr& Map::createTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks.getOrCreate(pos).create(pos) : m_nulltile; }
+const TilePtr& Map::getOrCreateTile(const Position& pos) { return pos.isMapPosition() ? m_floors[pos.z].tileBlocks.getOrCreate(pos).getOrCreate(pos) : m_nulltile; }
 
 template <typename... Items>
 const TilePtr& Map::createTileEx(const Position& pos, const Items&... items)
@@ -357,11 +437,8 @@ const TilePtr& Map::getTile(const Position& pos)
     if (!pos.isMapPosition())
         return m_nulltile;
 
-    auto& tileBlocks = m_floors[pos.z].tileBlocks;
-
-    const auto it = tileBlocks.find(getBlockIndex(pos));
-    if (it != tileBlocks.end())
-        return it->second.get(pos);
+    if (const auto block = m_floors[pos.z].tileBlocks.find(pos))
+        return block->get(pos);
 
     return m_nulltile;
 }
@@ -375,20 +452,20 @@ TileList Map::getTiles(const int8_t floor/* = -1*/)
     if (floor < 0) {
         // Search all floors
         for (auto z = -1; ++z <= g_gameConfig.getMapMaxZ();) {
-            for (const auto& [key, block] : m_floors[z].tileBlocks) {
+            m_floors[z].tileBlocks.forEach([&tiles](const TileBlock& block) {
                 for (const auto& tile : block.getTiles()) {
                     if (tile != nullptr)
                         tiles.emplace_back(tile);
                 }
-            }
+            });
         }
     } else {
-        for (const auto& [key, block] : m_floors[floor].tileBlocks) {
+        m_floors[floor].tileBlocks.forEach([&tiles](const TileBlock& block) {
             for (const auto& tile : block.getTiles()) {
                 if (tile != nullptr)
                     tiles.emplace_back(tile);
             }
-        }
+        });
     }
 
     return tiles;
@@ -399,13 +476,11 @@ void Map::cleanTile(const Position& pos)
     if (!pos.isMapPosition())
         return;
 
-    const auto it = m_floors[pos.z].tileBlocks.find(getBlockIndex(pos));
-    if (it != m_floors[pos.z].tileBlocks.end()) {
-        auto& block = it->second;
-        if (const auto& tile = block.get(pos)) {
+    if (const auto block = m_floors[pos.z].tileBlocks.find(pos)) {
+        if (const auto& tile = block->get(pos)) {
             tile->clean();
             if (tile->canErase())
-                block.remove(pos);
+                block->remove(pos);
 
             notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
         } else {
@@ -485,7 +560,7 @@ stdext::map<Position, ItemPtr, Position::Hasher> Map::findItemsById(const uint16
     stdext::map<Position, ItemPtr, Position::Hasher> ret;
     uint32_t  count = 0;
     for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
-        for (const auto& [uid, block] : m_floors[z].tileBlocks) {
+        m_floors[z].tileBlocks.forEach([&](const TileBlock& block) {
             for (const auto& tile : block.getTiles()) {
                 if (unlikely(!tile || tile->isEmpty()))
                     continue;
@@ -497,7 +572,7 @@ stdext::map<Position, ItemPtr, Position::Hasher> Map::findItemsById(const uint16
                     }
                 }
             }
-        }
+        });
     }
 
     return ret;
@@ -549,9 +624,7 @@ void Map::removeUnawareThings()
 
         // remove tiles that we are not aware anymore
         for (auto z = -1; ++z <= g_gameConfig.getMapMaxZ();) {
-            auto& tileBlocks = m_floors[z].tileBlocks;
-            for (auto it = tileBlocks.begin(); it != tileBlocks.end();) {
-                auto& block = it->second;
+            m_floors[z].tileBlocks.eraseIf([&](TileBlock& block) {
                 bool blockEmpty = true;
                 for (const auto& tile : block.getTiles()) {
                     if (!tile) continue;
@@ -569,11 +642,8 @@ void Map::removeUnawareThings()
                     notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
                 }
 
-                if (blockEmpty)
-                    it = tileBlocks.erase(it);
-                else
-                    ++it;
-            }
+                return blockEmpty;
+            });
         }
     }
 }
@@ -585,6 +655,9 @@ void Map::setCentralPosition(const Position& centralPosition)
 
     m_centralPosition = centralPosition;
 
+    for (auto& floor : m_floors)
+        floor.tileBlocks.recenter(centralPosition);
+
     removeUnawareThings();
 
     // this fixes local player position when the local player is removed from the map,
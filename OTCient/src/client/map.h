@@ -126,6 +126,73 @@ private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
 };
 
+// Tile blocks of a single floor. The blocks around the central position sit in a
+// ring grid indexed by their block coordinates, so looking up a tile near the player
+// never hashes. The grid is shifted as the player moves, blocks that fall out of it
+// (kept unaware tiles, maps loaded in the editor) are stored in a sparse map instead.
+class TileBlockGrid
+{
+public:
+    // blocks per side, a power of two wide enough for the aware range with the map cache
+    static constexpr uint32_t GRID_SIZE = 8;
+
+    TileBlock* find(const Position& pos) const
+    {
+        const uint32_t index = getBlockIndex(pos);
+        const auto& slot = m_slots[getSlotIndex(pos)];
+        if (slot.index == index)
+            return slot.block.get();
+
+        if (m_blocks.empty())
+            return nullptr;
+
+        const auto it = m_blocks.find(index);
+        return it != m_blocks.end() ? it->second.get() : nullptr;
+    }
+
+    TileBlock& getOrCreate(const Position& pos);
+
+    // moves the blocks around the given central position into the grid
+    void recenter(const Position& centralPosition);
+
+    // removes the blocks for which eraseBlock(block) returns true
+    void eraseIf(const std::function<bool(TileBlock&)>& eraseBlock);
+
+    void clear();
+
+    template<typename F>
+    void forEach(F&& f) const
+    {
+        for (const auto& slot : m_slots) {
+            if (slot.block)
+                f(*slot.block);
+        }
+
+        for (const auto& [index, block] : m_blocks)
+            f(*block);
+    }
+
+private:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t index{ INVALID_INDEX };
+        std::unique_ptr<TileBlock> block;
+    };
+
+    static constexpr uint32_t BLOCKS_PER_SIDE = 65536 / BLOCK_SIZE;
+
+    static uint32_t getBlockIndex(const uint32_t blockX, const uint32_t blockY) { return blockY * BLOCKS_PER_SIDE + blockX; }
+    static uint32_t getBlockIndex(const Position& pos) { return getBlockIndex(pos.x / BLOCK_SIZE, pos.y / BLOCK_SIZE); }
+    static uint32_t getSlotIndex(const uint32_t blockX, const uint32_t blockY) { return (blockY % GRID_SIZE) * GRID_SIZE + (blockX % GRID_SIZE); }
+    static uint32_t getSlotIndex(const Position& pos) { return getSlotIndex(pos.x / BLOCK_SIZE, pos.y / BLOCK_SIZE); }
+
+    std::array<Slot, GRID_SIZE* GRID_SIZE> m_slots;
+    std::unordered_map<uint32_t, std::unique_ptr<TileBlock>> m_blocks;
+    uint32_t m_centralBlock{ INVALID_INDEX };
+};
+
 struct PathFindResult
 {
     Otc::PathFindResult status = Otc::PathFindResultNoWay;
@@ -308,13 +375,11 @@ private:
     struct FloorData
     {
         std::vector<MissilePtr> missiles;
-        std::unordered_map<uint32_t, TileBlock > tileBlocks;
+        TileBlockGrid tileBlocks;
     };
 
     void removeUnawareThings();
 
-    uint16_t getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
-
     std::vector<FloorData> m_floors;
 
     std::vector<AnimatedTextPtr> m_animatedTexts;
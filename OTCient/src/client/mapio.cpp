@@ -305,8 +305,7 @@ void Map::saveOtbm(const std::string& fileName)
                 bool firstNode = true;
 
                 for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
-                    for (const auto& it : m_floors[z].tileBlocks) {
-                        const TileBlock& block = it.second;
+                    m_floors[z].tileBlocks.forEach([&](const TileBlock& block) {
                         for (const TilePtr& tile : block.getTiles()) {
                             if (unlikely(!tile || tile->isEmpty()))
                                 continue;
@@ -358,7 +357,7 @@ void Map::saveOtbm(const std::string& fileName)
 
                             root->endNode(); // OTBM_TILE
                         }
-                    }
+                    });
                 }
 
                 if (!firstNode)
@@ -508,8 +507,7 @@ void Map::saveOtcm(const std::string& fileName)
         fin->seek(start);
 
         for (uint8_t z = 0; z <= g_gameConfig.getMapMaxZ(); ++z) {
-            for (const auto& it : m_floors[z].tileBlocks) {
-                const TileBlock& block = it.second;
+            m_floors[z].tileBlocks.forEach([&](const TileBlock& block) {
                 for (const TilePtr& tile : block.getTiles()) {
                     if (!tile || tile->isEmpty())
                         continue;
@@ -530,7 +528,7 @@ void Map::saveOtcm(const std::string& fileName)
                     // end of tile
                     fin->addU16(0xFFFF);
                 }
-            }
+            });
         }
 
         // end of file
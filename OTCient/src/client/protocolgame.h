@@ -164,6 +164,18 @@ public:
     // otclient only
     void sendChangeMapAwareRange(uint8_t xrange, uint8_t yrange);
 
+    // parse cost of every server opcode, collected while benchmarking a record
+    struct OpcodeStats
+    {
+        uint32_t count{ 0 };
+        ticks_t micros{ 0 };
+    };
+
+    void setOpcodeProfiling(bool enable) { m_opcodeProfiling = enable; }
+    bool isOpcodeProfiling() const { return m_opcodeProfiling; }
+    const std::array<OpcodeStats, 256>& getOpcodeStats() const { return m_opcodeStats; }
+    uint32_t getParsedMessages() const { return m_parsedMessages; }
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -383,6 +395,10 @@ private:
     bool m_mapKnown{ false };
     bool m_firstRecv{ true };
     bool m_record {false};
+    bool m_opcodeProfiling{ false };
+
+    uint32_t m_parsedMessages{ 0 };
+    std::array<OpcodeStats, 256> m_opcodeStats{};
 
     std::string m_accountName;
     std::string m_accountPassword;
@@ -40,9 +40,24 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
 {
     int opcode = -1;
     int prevOpcode = -1;
+    ticks_t opcodeStart = 0;
+
+    const auto addOpcodeCost = [&] {
+        if (m_opcodeProfiling) {
+            auto& stats = m_opcodeStats[opcode];
+            ++stats.count;
+            stats.micros += stdext::micros() - opcodeStart;
+        }
+    };
+
+    ++m_parsedMessages;
 
     try {
         while (!msg->eof()) {
+            if (m_opcodeProfiling) {
+                opcodeStart = stdext::micros();
+            }
+
             opcode = msg->getU8();
 
             // must be > so extended will be enabled before GameStart.
@@ -56,6 +71,7 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
             // try to parse in lua first
             const int readPos = msg->getReadPos();
             if (callLuaField<bool>("onOpcode", opcode, msg)) {
+                addOpcodeCost();
                 continue;
             }
             msg->setReadPos(readPos);
@@ -604,6 +620,7 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 default:
                     throw Exception("unhandled opcode {}", opcode);
             }
+            addOpcodeCost();
             prevOpcode = opcode;
         }
     } catch (const stdext::exception& e) {
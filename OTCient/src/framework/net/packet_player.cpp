@@ -86,6 +86,22 @@ void PacketPlayer::onOutputPacket(const OutputMessagePtr& packet)
 
 void PacketPlayer::process()
 {
+    if (m_fastForward) {
+        // hand the packets over in batches so the dispatcher keeps running in between
+        for (size_t i = 0; i < FAST_FORWARD_BATCH && !m_input.empty(); ++i) {
+            m_recvCallback(m_input.front().second);
+            m_input.pop_front();
+        }
+
+        if (!m_input.empty()) {
+            m_event = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, this), 0);
+        } else {
+            m_disconnectCallback(asio::error::eof);
+            stop();
+        }
+        return;
+    }
+
     ticks_t nextPacket = 1;
     while (!m_input.empty()) {
         auto& packet = m_input.front();
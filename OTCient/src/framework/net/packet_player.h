@@ -36,9 +36,16 @@ public:
 
     void onOutputPacket(const OutputMessagePtr& packet);
 
+    // replays the packets back to back instead of at their recorded times
+    void setFastForward(bool fastForward) { m_fastForward = fastForward; }
+    bool isFastForward() const { return m_fastForward; }
+
 private:
     void process();
 
+    static constexpr size_t FAST_FORWARD_BATCH = 256;
+
+    bool m_fastForward{ false };
     ticks_t m_start;
     ScheduledEventPtr m_event;
     std::deque<std::pair<ticks_t, std::shared_ptr<std::vector<uint8_t>>>> m_input;
@@ -31,6 +31,7 @@ allowClones = false
 allowWalkthrough = true
 serverName = "Nexus"
 statusTimeout = 5000
+statusCacheTime = 2000
 replaceKickOnLogin = true
 maxPacketsPerSecond = 25
 
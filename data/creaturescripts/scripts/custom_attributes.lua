@@ -1,6 +1,5 @@
 function onLogin(player)
 	player:registerEvent("CustomAttributesThink")
-	player:registerEvent("CustomAttributesHealth")
 	player:registerEvent("CustomAttributesMana")
 
 	local weight = player:getCustomAttribute(18)
@@ -53,11 +52,6 @@ function onThink(creature, interval)
 	return true
 end
 
-function onHealthChange(creature, attacker, primaryDamage, primaryType, secondaryDamage, secondaryType, origin)
-	-- unchanged logic here (paste your original block)
-	return primaryDamage, primaryType, secondaryDamage, secondaryType
-end
-
 function onManaChange(creature, attacker, primaryDamage, primaryType, secondaryDamage, secondaryType, origin)
 	local player = creature:getPlayer()
 	if player and primaryDamage < 0 and origin == ORIGIN_SPELL then
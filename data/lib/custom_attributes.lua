@@ -3,20 +3,8 @@ CustomAttributes.attributes = {}
 CustomAttributes.storageBase = 220000
 
 function CustomAttributes.load()
-	local path = 'data/XML/custom_attributes.xml'
-	for line in io.lines(path) do
-		local id = tonumber(line:match('id="(%d+)"'))
-		if id then
-			local name = line:match('name="([^"]+)"') or ''
-			local desc = line:match('description="([^"]+)"') or ''
-			local group = line:match('group="([^"]+)"') or ''
-			CustomAttributes.attributes[id] = {
-				name = name,
-				description = desc,
-				group = group
-			}
-		end
-	end
+	-- definitions are parsed by the server from data/XML/custom_attributes.xml
+	CustomAttributes.attributes = Game.getCustomAttributes()
 end
 
 function CustomAttributes.getName(id)
@@ -38,14 +26,7 @@ function CustomAttributes.getKey(id)
 	return CustomAttributes.storageBase + id
 end
 
-function Player.getCustomAttribute(self, id)
-	local value = self:getStorageValue(CustomAttributes.getKey(id))
-	if value < 0 then
-		return 0
-	end
-	return value
-end
-
+-- sets the base value, player:getCustomAttribute(id) adds the equipped items on top
 function Player.setCustomAttribute(self, id, value)
 	self:setStorageValue(CustomAttributes.getKey(id), value)
 end
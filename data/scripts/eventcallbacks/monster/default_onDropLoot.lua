@@ -14,7 +14,7 @@ event.onDropLoot = function(self, corpse)
 	end
 
         if doCreateLoot then
-                local monsterLoot = mType:getLoot()
+                local monsterLoot = self:getLoot()
                 local bonus = 0
                 if player then
                         bonus = player:getCustomAttribute(20)
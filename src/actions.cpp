@@ -40,6 +40,7 @@ void Actions::clear(bool fromLua) {
 	clearMap(useItemMap, fromLua);
 	clearMap(uniqueItemMap, fromLua);
 	clearMap(actionItemMap, fromLua);
+	lookupChanged = true;
 
 	reInitState(fromLua);
 }
@@ -57,6 +58,7 @@ Event_ptr Actions::getEvent(const std::string& nodeName) {
 
 bool Actions::registerEvent(Event_ptr event, const pugi::xml_node& node) {
 	Action_ptr action{static_cast<Action*>(event.release())}; //event is guaranteed to be an Action
+	lookupChanged = true;
 
 	pugi::xml_attribute attr;
 	if ((attr = node.attribute("itemid"))) {
@@ -182,6 +184,8 @@ bool Actions::registerEvent(Event_ptr event, const pugi::xml_node& node) {
 
 bool Actions::registerLuaEvent(Action* event) {
 	Action_ptr action{ event };
+	lookupChanged = true;
+
 	if (isValid(ids, event)) {
 		const auto& range = getItemIdRange(event);
 		for (auto& id : range) {
@@ -260,28 +264,49 @@ ReturnValue Actions::canUseFar(const Creature* creature, const Position& toPos,
 
 Action* Actions::getAction(const Item* item) {
 	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID)) {
-		auto it = uniqueItemMap.find(item->getUniqueId());
-		if (it != uniqueItemMap.end()) {
+		if (uniqueItemMap.empty()) {
+			++lookupsSkipped;
+		} else if (auto it = uniqueItemMap.find(item->getUniqueId()); it != uniqueItemMap.end()) {
 			return &it->second;
 		}
 	}
 
 	if (item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
-		auto it = actionItemMap.find(item->getActionId());
-		if (it != actionItemMap.end()) {
+		if (actionItemMap.empty()) {
+			++lookupsSkipped;
+		} else if (auto it = actionItemMap.find(item->getActionId()); it != actionItemMap.end()) {
 			return &it->second;
 		}
 	}
 
-	auto it = useItemMap.find(item->getID());
-	if (it != useItemMap.end()) {
-		return &it->second;
+	updateLookup();
+
+	const uint16_t itemId = item->getID();
+	if (itemId < useItemLookup.size() && useItemLookup[itemId]) {
+		return useItemLookup[itemId];
 	}
+	++lookupsSkipped;
 
 	//rune items
 	return g_spells->getRuneSpell(item->getID());
 }
 
+void Actions::updateLookup() {
+	if (!lookupChanged) {
+		return;
+	}
+
+	lookupChanged = false;
+
+	useItemLookup.clear();
+	for (auto& [id, action] : useItemMap) {
+		if (id >= useItemLookup.size()) {
+			useItemLookup.resize(id + 1);
+		}
+		useItemLookup[id] = &action;
+	}
+}
+
 ReturnValue Actions::internalUseItem(Player* player, const Position& pos, uint8_t index, Item* item, bool isHotkey) {
 	if (Door* door = item->getDoor()) {
 		if (!door->canUse(player)) {
@@ -82,6 +82,10 @@ class Actions final : public BaseEvents {
 		bool registerLuaEvent(Action* event);
 		void clear(bool fromLua) override final;
 
+		uint64_t getLookupsSkipped() const {
+			return lookupsSkipped;
+		}
+
 		bool isValid(std::map<Action*, std::vector<uint16_t>> map, Action* action) {
 			return map.find(action) != map.end();
 		}
@@ -126,17 +130,23 @@ class Actions final : public BaseEvents {
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
-		using ActionUseMap = std::map<uint16_t, Action>;
+		using ActionUseMap = std::unordered_map<uint16_t, Action>;
 		ActionUseMap useItemMap;
 		ActionUseMap uniqueItemMap;
 		ActionUseMap actionItemMap;
 
+		// useItemMap indexed by item id, rebuilt on the first lookup after a change
+		std::vector<Action*> useItemLookup;
+		bool lookupChanged = true;
+		uint64_t lookupsSkipped = 0;
+
 		std::map<Action*, std::vector<uint16_t>> ids;
 		std::map<Action*, std::vector<uint16_t>> uids;
 		std::map<Action*, std::vector<uint16_t>> aids;
 
 		Action* getAction(const Item* item);
 		void clearMap(ActionUseMap& map, bool fromLua);
+		void updateLookup();
 
 		LuaScriptInterface scriptInterface;
 };
@@ -10,9 +10,7 @@
 #include "databasetasks.h"
 
 namespace IOBan {
-	const std::optional<BanInfo> getAccountBanInfo(uint32_t accountId) {
-		Database& db = Database::getInstance();
-
+	const std::optional<BanInfo> getAccountBanInfo(Database& db, uint32_t accountId) {
 		DBResult_ptr result = db.storeQuery(fmt::format("SELECT `reason`, `expires_at`, `banned_at`, `banned_by`, (SELECT `name` FROM `players` WHERE `id` = `banned_by`) AS `name` FROM `account_bans` WHERE `account_id` = {:d}", accountId));
 		if (!result) {
 			return std::nullopt;
@@ -38,13 +36,11 @@ namespace IOBan {
 		return banInfo;
 	}
 
-	const std::optional<BanInfo> getIpBanInfo(const Connection::Address& clientIP) {
+	const std::optional<BanInfo> getIpBanInfo(Database& db, const Connection::Address& clientIP) {
 		if (clientIP.is_unspecified()) {
 			return std::nullopt;
 		}
 
-		Database& db = Database::getInstance();
-
 		DBResult_ptr result = db.storeQuery(fmt::format("SELECT `reason`, `expires_at`, (SELECT `name` FROM `players` WHERE `id` = `banned_by`) AS `name` FROM `ip_bans` WHERE `ip` = INET6_ATON('{:s}')", clientIP.to_string()));
 		if (!result) {
 			return std::nullopt;
@@ -68,8 +64,8 @@ namespace IOBan {
 		return banInfo;
 	}
 
-	bool isPlayerNamelocked(uint32_t playerId) {
-		return Database::getInstance().storeQuery(fmt::format("SELECT 1 FROM `player_namelocks` WHERE `player_id` = {:d}", playerId)).get();
+	bool isPlayerNamelocked(Database& db, uint32_t playerId) {
+		return db.storeQuery(fmt::format("SELECT 1 FROM `player_namelocks` WHERE `player_id` = {:d}", playerId)).get();
 	}
 
 } // namespace IOBan
\ No newline at end of file
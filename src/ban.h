@@ -6,6 +6,8 @@
 
 #include "connection.h"
 
+class Database;
+
 namespace IOBan {
 
 	struct BanInfo {
@@ -14,9 +16,10 @@ namespace IOBan {
 		time_t expiresAt;
 	};
 
-	const std::optional<BanInfo> getAccountBanInfo(uint32_t accountId);
-	const std::optional<BanInfo> getIpBanInfo(const Connection::Address& clientIP);
-	bool isPlayerNamelocked(uint32_t playerId);
+	// the login checks run on the database thread and pass its connection
+	const std::optional<BanInfo> getAccountBanInfo(Database& db, uint32_t accountId);
+	const std::optional<BanInfo> getIpBanInfo(Database& db, const Connection::Address& clientIP);
+	bool isPlayerNamelocked(Database& db, uint32_t playerId);
 
 }; // namespace IOBan
 
@@ -241,10 +241,16 @@ void BedItem::internalSetSleeper(const Player* player) {
 	sleeperGUID = player->getGUID();
 	sleepStart = time(nullptr);
 	setSpecialDescription(desc_str);
+	if (house) {
+		house->setItemsChanged();
+	}
 }
 
 void BedItem::internalRemoveSleeper() {
 	sleeperGUID = 0;
 	sleepStart = 0;
 	setSpecialDescription("Nobody is sleeping there.");
+	if (house) {
+		house->setItemsChanged();
+	}
 }
\ No newline at end of file
@@ -33,8 +33,8 @@ void PrivateChatChannel::invitePlayer(const Player& player, Player& invitePlayer
 
 	player.sendTextMessage(MESSAGE_INFO_DESCR, fmt::format("{:s} has been invited.", invitePlayer.getName()));
 
-	for (const auto& it : users) {
-		it.second->sendChannelEvent(id, invitePlayer.getName(), CHANNELEVENT_INVITE);
+	for (Player* user : users) {
+		user->sendChannelEvent(id, invitePlayer.getName(), CHANNELEVENT_INVITE);
 	}
 }
 
@@ -49,19 +49,19 @@ void PrivateChatChannel::excludePlayer(const Player& player, Player& excludePlay
 
 	excludePlayer.sendClosePrivate(id);
 
-	for (const auto& it : users) {
-		it.second->sendChannelEvent(id, excludePlayer.getName(), CHANNELEVENT_EXCLUDE);
+	for (Player* user : users) {
+		user->sendChannelEvent(id, excludePlayer.getName(), CHANNELEVENT_EXCLUDE);
 	}
 }
 
 void PrivateChatChannel::closeChannel() const {
-	for (const auto& it : users) {
-		it.second->sendClosePrivate(id);
+	for (Player* user : users) {
+		user->sendClosePrivate(id);
 	}
 }
 
 bool ChatChannel::addUser(Player& player) {
-	if (users.find(player.getID()) != users.end()) {
+	if (hasUser(player)) {
 		return false;
 	}
 
@@ -78,26 +78,34 @@ bool ChatChannel::addUser(Player& player) {
 	}
 
 	if (!publicChannel) {
-		for (const auto& it : users) {
-			it.second->sendChannelEvent(id, player.getName(), CHANNELEVENT_JOIN);
+		for (Player* user : users) {
+			user->sendChannelEvent(id, player.getName(), CHANNELEVENT_JOIN);
 		}
 	}
 
-	users[player.getID()] = &player;
+	userIndex.emplace(player.getID(), users.size());
+	users.push_back(&player);
 	return true;
 }
 
 bool ChatChannel::removeUser(const Player& player) {
-	auto iter = users.find(player.getID());
-	if (iter == users.end()) {
+	auto iter = userIndex.find(player.getID());
+	if (iter == userIndex.end()) {
 		return false;
 	}
 
-	users.erase(iter);
+	// the last member takes over the freed slot
+	const size_t index = iter->second;
+	userIndex.erase(iter);
+	if (index != users.size() - 1) {
+		users[index] = users.back();
+		userIndex[users[index]->getID()] = index;
+	}
+	users.pop_back();
 
 	if (!publicChannel) {
-		for (const auto& it : users) {
-			it.second->sendChannelEvent(id, player.getName(), CHANNELEVENT_LEAVE);
+		for (Player* user : users) {
+			user->sendChannelEvent(id, player.getName(), CHANNELEVENT_LEAVE);
 		}
 	}
 
@@ -106,22 +114,27 @@ bool ChatChannel::removeUser(const Player& player) {
 }
 
 bool ChatChannel::hasUser(const Player& player) {
-	return users.find(player.getID()) != users.end();
+	return userIndex.find(player.getID()) != userIndex.end();
 }
 
 void ChatChannel::sendToAll(const std::string& message, SpeakClasses type) const {
-	for (const auto& it : users) {
-		it.second->sendChannelMessage("", message, type, id);
+	// encoded once and copied into the output of every member
+	NetworkMessage msg;
+	ProtocolGame::AddChannelMessage(msg, "", message, type, id);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 }
 
 bool ChatChannel::talk(const Player& fromPlayer, SpeakClasses type, const std::string& text) {
-	if (users.find(fromPlayer.getID()) == users.end()) {
+	if (!hasUser(fromPlayer)) {
 		return false;
 	}
 
-	for (const auto& it : users) {
-		it.second->sendToChannel(&fromPlayer, type, text, id);
+	NetworkMessage msg;
+	ProtocolGame::AddCreatureChannelMessage(msg, &fromPlayer, type, text, id);
+	for (Player* user : users) {
+		user->sendNetworkMessage(msg);
 	}
 	return true;
 }
@@ -282,9 +295,11 @@ bool Chat::load() {
 				}
 			}
 
-			UsersMap tempUserMap = std::move(channel.users);
-			for (const auto& pair : tempUserMap) {
-				channel.addUser(*pair.second);
+			UserList tempUsers = std::move(channel.users);
+			channel.users.clear();
+			channel.userIndex.clear();
+			for (Player* user : tempUsers) {
+				channel.addUser(*user);
 			}
 			continue;
 		}
@@ -10,7 +10,7 @@
 class Party;
 class Player;
 
-using UsersMap = std::map<uint32_t, Player*>;
+using UserList = std::vector<Player*>;
 using InvitedMap = std::map<uint32_t, const Player*>;
 
 class ChatChannel {
@@ -34,7 +34,7 @@ class ChatChannel {
 		uint16_t getId() const {
 			return id;
 		}
-		const UsersMap& getUsers() const {
+		const UserList& getUsers() const {
 			return users;
 		}
 		virtual const InvitedMap* getInvitedUsers() const {
@@ -53,7 +53,9 @@ class ChatChannel {
 		bool executeOnSpeakEvent(const Player& player, SpeakClasses& type, const std::string& message);
 
 	protected:
-		UsersMap users;
+		// members are kept in a flat list for broadcasting, indexed by player id
+		UserList users;
+		std::unordered_map<uint32_t, size_t> userIndex;
 
 		uint16_t id;
 
@@ -134,8 +136,8 @@ class Chat {
 	private:
 		std::map<uint16_t, ChatChannel> normalChannels;
 		std::map<uint16_t, PrivateChatChannel> privateChannels;
-		std::map<Party*, ChatChannel> partyChannels;
-		std::map<uint32_t, ChatChannel> guildChannels;
+		std::unordered_map<Party*, ChatChannel> partyChannels;
+		std::unordered_map<uint32_t, ChatChannel> guildChannels;
 
 		LuaScriptInterface scriptInterface;
 
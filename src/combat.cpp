@@ -15,47 +15,76 @@
 extern Game g_game;
 extern Weapons* g_weapons;
 
-std::vector<Tile*> getList(const MatrixArea& area, const Position& targetPos, const Direction dir) {
-	auto casterPos = getNextPosition(dir, targetPos);
+namespace {
+
+// per-thread pool of scratch vectors reused between casts; a nested cast started
+// from a script callback takes its own vector from the pool
+template <typename T>
+class ScratchBuffer {
+	public:
+		ScratchBuffer() {
+			if (!pool.empty()) {
+				buffer = std::move(pool.back());
+				pool.pop_back();
+			}
+		}
+		~ScratchBuffer() {
+			buffer.clear();
+			pool.push_back(std::move(buffer));
+		}
 
-	std::vector<Tile*> vec;
+		// non-copyable
+		ScratchBuffer(const ScratchBuffer&) = delete;
+		ScratchBuffer& operator=(const ScratchBuffer&) = delete;
 
-	auto center = area.getCenter();
+		std::vector<T>& operator*() { return buffer; }
 
-	Position tmpPos(targetPos.x - center.first, targetPos.y - center.second, targetPos.z);
-	for (uint32_t row = 0; row < area.getRows(); ++row, ++tmpPos.y) {
-		for (uint32_t col = 0; col < area.getCols(); ++col, ++tmpPos.x) {
-			if (area(row, col)) {
-				if (g_game.isSightClear(casterPos, tmpPos, true)) {
-					Tile* tile = g_game.map.getTile(tmpPos);
-					if (!tile) {
-						tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
-						g_game.map.setTile(tmpPos, tile);
-					}
-					vec.push_back(tile);
-				}
-			}
+	private:
+		std::vector<T> buffer;
+
+		static thread_local std::vector<std::vector<T>> pool;
+};
+
+template <typename T>
+thread_local std::vector<std::vector<T>> ScratchBuffer<T>::pool;
+
+Tile* getOrCreateTile(const Position& pos) {
+	Tile* tile = g_game.map.getTile(pos);
+	if (!tile) {
+		tile = new StaticTile(pos.x, pos.y, pos.z);
+		g_game.map.setTile(pos, tile);
+	}
+	return tile;
+}
+
+void getList(const AreaTemplate& area, const Position& targetPos, const Direction dir, std::vector<Tile*>& tiles) {
+	auto casterPos = getNextPosition(dir, targetPos);
+
+	tiles.reserve(area.offsets.size());
+	for (auto&& [offsetX, offsetY] : area.offsets) {
+		Position tmpPos(targetPos.x + offsetX, targetPos.y + offsetY, targetPos.z);
+		if (g_game.isSightClear(casterPos, tmpPos, true)) {
+			tiles.push_back(getOrCreateTile(tmpPos));
 		}
-		tmpPos.x -= area.getCols();
 	}
-	return vec;
 }
 
-std::vector<Tile*> getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area) {
+// fills tiles with the tiles hit around targetPos and returns the template reach in tiles
+std::pair<int32_t, int32_t> getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::vector<Tile*>& tiles) {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
-		return {};
+		return {0, 0};
 	}
 
 	if (area) {
-		return getList(area->getArea(centerPos, targetPos), targetPos, getDirectionTo(targetPos, centerPos));
+		const AreaTemplate& areaTemplate = area->getArea(centerPos, targetPos);
+		getList(areaTemplate, targetPos, getDirectionTo(targetPos, centerPos), tiles);
+		return {areaTemplate.rangeX, areaTemplate.rangeY};
 	}
 
-	Tile* tile = g_game.map.getTile(targetPos);
-	if (!tile) {
-		tile = new StaticTile(targetPos.x, targetPos.y, targetPos.z);
-		g_game.map.setTile(targetPos, tile);
-	}
-	return {tile};
+	tiles.push_back(getOrCreateTile(targetPos));
+	return {0, 0};
+}
+
 }
 
 CombatDamage Combat::getCombatDamage(Creature* creature, Creature* target) const {
@@ -687,22 +716,14 @@ void Combat::doCombat(Creature* caster, const Position& position) const {
 		CombatDamage damage = getCombatDamage(caster, nullptr);
 		doAreaCombat(caster, position, area.get(), damage, params);
 	} else {
-		auto tiles = caster ? getCombatArea(caster->getPosition(), position, area.get()) : getCombatArea(position, position, area.get());
-
-		SpectatorVec spectators;
-		int32_t maxX = 0;
-		int32_t maxY = 0;
-
-		//calculate the max viewable range
-		for (Tile* tile : tiles) {
-			const Position& tilePos = tile->getPosition();
-
-			maxX = std::max(maxX, tilePos.getDistanceX(position));
-			maxY = std::max(maxY, tilePos.getDistanceY(position));
-		}
+		ScratchBuffer<Tile*> tileBuffer;
+		auto& tiles = *tileBuffer;
+		auto [maxX, maxY] = getCombatArea(caster ? caster->getPosition() : position, position, area.get(), tiles);
 
 		const int32_t rangeX = maxX + Map::maxViewportX;
 		const int32_t rangeY = maxY + Map::maxViewportY;
+
+		SpectatorVec spectators;
 		g_game.map.getSpectators(spectators, position, true, true, rangeX, rangeX, rangeY, rangeY);
 
 		postCombatEffects(caster, position, params);
@@ -856,7 +877,9 @@ void Combat::doTargetCombat(Creature* caster, Creature* target, CombatDamage& da
 }
 
 void Combat::doAreaCombat(Creature* caster, const Position& position, const AreaCombat* area, CombatDamage& damage, const CombatParams& params) {
-	auto tiles = caster ? getCombatArea(caster->getPosition(), position, area) : getCombatArea(position, position, area);
+	ScratchBuffer<Tile*> tileBuffer;
+	auto& tiles = *tileBuffer;
+	auto [maxX, maxY] = getCombatArea(caster ? caster->getPosition() : position, position, area, tiles);
 
 	Player* casterPlayer = caster ? caster->getPlayer() : nullptr;
 	int32_t criticalPrimary = 0;
@@ -871,17 +894,6 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 		}
 	}
 
-	int32_t maxX = 0;
-	int32_t maxY = 0;
-
-	//calculate the max viewable range
-	for (Tile* tile : tiles) {
-		const Position& tilePos = tile->getPosition();
-
-		maxX = std::max(maxX, tilePos.getDistanceX(position));
-		maxY = std::max(maxY, tilePos.getDistanceY(position));
-	}
-
 	const int32_t rangeX = maxX + Map::maxViewportX;
 	const int32_t rangeY = maxY + Map::maxViewportY;
 
@@ -890,8 +902,8 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 
 	postCombatEffects(caster, position, params);
 
-	std::vector<Creature*> toDamageCreatures;
-	toDamageCreatures.reserve(100);
+	ScratchBuffer<Creature*> creatureBuffer;
+	auto& toDamageCreatures = *creatureBuffer;
 
 	for (Tile* tile : tiles) {
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
@@ -924,6 +936,9 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 		}
 	}
 
+	// hit effects and health bars of every target are sent once the whole area has been resolved
+	g_game.beginCombatEvents(position, maxX, maxY);
+
 	CombatDamage leechCombat;
 	leechCombat.origin = ORIGIN_NONE;
 	leechCombat.leeched = true;
@@ -943,7 +958,7 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 		if (damageCopy.critical) {
 			damageCopy.primary.value += playerCombatReduced ? criticalPrimary / 2 : criticalPrimary;
 			damageCopy.secondary.value += playerCombatReduced ? criticalSecondary / 2 : criticalSecondary;
-			g_game.addMagicEffect(creature->getPosition(), CONST_ME_CRITICAL_DAMAGE);
+			g_game.addCombatMagicEffect(creature->getPosition(), CONST_ME_CRITICAL_DAMAGE);
 		}
 
 		bool success = false;
@@ -1008,6 +1023,8 @@ void Combat::doAreaCombat(Creature* caster, const Position& position, const Area
 			params.targetCallback->onTargetCombat(caster, creature);
 		}
 	}
+
+	g_game.flushCombatEvents();
 }
 
 //**********************************************************//
@@ -1168,7 +1185,23 @@ void TargetCallback::onTargetCombat(Creature* creature, Creature* target) const
 
 //**********************************************************//
 
-const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position& targetPos) const {
+AreaTemplate::AreaTemplate(const MatrixArea& area) {
+	auto&& [centerX, centerY] = area.getCenter();
+	for (uint32_t row = 0; row < area.getRows(); ++row) {
+		for (uint32_t col = 0; col < area.getCols(); ++col) {
+			if (area(row, col)) {
+				int32_t offsetX = static_cast<int32_t>(col) - static_cast<int32_t>(centerX);
+				int32_t offsetY = static_cast<int32_t>(row) - static_cast<int32_t>(centerY);
+				offsets.emplace_back(offsetX, offsetY);
+				rangeX = std::max(rangeX, std::abs(offsetX));
+				rangeY = std::max(rangeY, std::abs(offsetY));
+			}
+		}
+	}
+	offsets.shrink_to_fit();
+}
+
+const AreaTemplate& AreaCombat::getArea(const Position& centerPos, const Position& targetPos) const {
 	int32_t dx = targetPos.getOffsetX(centerPos);
 	int32_t dy = targetPos.getOffsetY(centerPos);
 
@@ -1197,7 +1230,7 @@ const MatrixArea& AreaCombat::getArea(const Position& centerPos, const Position&
 
 	if (dir >= areas.size()) {
 		// this should not happen. it means we forgot to call setupArea.
-		static MatrixArea empty;
+		static AreaTemplate empty;
 		return empty;
 	}
 	return areas[dir];
@@ -1209,10 +1242,10 @@ void AreaCombat::setupArea(const std::vector<uint32_t>& vec, uint32_t rows) {
 		areas.resize(4);
 	}
 
-	areas[DIRECTION_EAST] = area.rotate90();
-	areas[DIRECTION_SOUTH] = area.rotate180();
-	areas[DIRECTION_WEST] = area.rotate270();
-	areas[DIRECTION_NORTH] = std::move(area);
+	areas[DIRECTION_EAST] = AreaTemplate(area.rotate90());
+	areas[DIRECTION_SOUTH] = AreaTemplate(area.rotate180());
+	areas[DIRECTION_WEST] = AreaTemplate(area.rotate270());
+	areas[DIRECTION_NORTH] = AreaTemplate(area);
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -1323,10 +1356,10 @@ void AreaCombat::setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows) {
 	hasExtArea = true;
 	auto area = createArea(vec, rows);
 	areas.resize(8);
-	areas[DIRECTION_NORTHEAST] = area.rotate90();
-	areas[DIRECTION_SOUTHEAST] = area.rotate180();
-	areas[DIRECTION_SOUTHWEST] = area.rotate270();
-	areas[DIRECTION_NORTHWEST] = std::move(area);
+	areas[DIRECTION_NORTHEAST] = AreaTemplate(area.rotate90());
+	areas[DIRECTION_SOUTHEAST] = AreaTemplate(area.rotate180());
+	areas[DIRECTION_SOUTHWEST] = AreaTemplate(area.rotate270());
+	areas[DIRECTION_NORTHWEST] = AreaTemplate(area);
 }
 
 //**********************************************************//
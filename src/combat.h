@@ -61,6 +61,16 @@ struct CombatParams {
 	bool ignoreResistances = false;
 };
 
+// an area matrix compiled into the offsets of its affected cells, relative to its center
+struct AreaTemplate {
+	AreaTemplate() = default;
+	explicit AreaTemplate(const MatrixArea& area);
+
+	std::vector<std::pair<int16_t, int16_t>> offsets;
+	int32_t rangeX = 0;
+	int32_t rangeY = 0;
+};
+
 class AreaCombat {
 	public:
 		void setupArea(const std::vector<uint32_t>& vec, uint32_t rows);
@@ -68,10 +78,10 @@ class AreaCombat {
 		void setupArea(int32_t radius);
 		void setupAreaRing(int32_t ring);
 		void setupExtArea(const std::vector<uint32_t>& vec, uint32_t rows);
-		const MatrixArea& getArea(const Position& centerPos, const Position& targetPos) const;
+		const AreaTemplate& getArea(const Position& centerPos, const Position& targetPos) const;
 
 	private:
-		std::vector<MatrixArea> areas;
+		std::vector<AreaTemplate> areas;
 		bool hasExtArea = false;
 };
 
@@ -1237,7 +1237,7 @@ bool ConditionDamage::init() {
 			startDamage = std::max<int32_t>(1, std::ceil(amount / 20.0));
 		}
 
-		std::list<int32_t> list;
+		std::vector<int32_t> list;
 		ConditionDamage::generateDamageList(amount, startDamage, list);
 		for (int32_t value : list) {
 			addDamage(1, tickInterval, -value);
@@ -1283,7 +1283,7 @@ bool ConditionDamage::executeCondition(Creature* creature, int32_t interval) {
 			int32_t damage = damageInfo.value;
 
 			if (bRemove) {
-				damageList.pop_front();
+				damageList.erase(damageList.begin());
 			} else {
 				damageInfo.timeLeft = damageInfo.interval;
 			}
@@ -1311,7 +1311,7 @@ bool ConditionDamage::getNextDamage(int32_t& damage) {
 		IntervalInfo& damageInfo = damageList.front();
 		damage = damageInfo.value;
 		if (ticks != -1) {
-			damageList.pop_front();
+			damageList.erase(damageList.begin());
 		}
 		return true;
 	}
@@ -1454,7 +1454,7 @@ uint32_t ConditionDamage::getIcons() const {
 	return icons;
 }
 
-void ConditionDamage::generateDamageList(int32_t amount, int32_t start, std::list<int32_t>& list) {
+void ConditionDamage::generateDamageList(int32_t amount, int32_t start, std::vector<int32_t>& list) {
 	amount = std::abs(amount);
 	int32_t sum = 0;
 	double x1, x2;
@@ -244,7 +244,7 @@ class ConditionDamage final : public Condition {
 		ConditionDamage(ConditionId_t id, ConditionType_t type, bool buff = false, uint32_t subId = 0, bool aggressive = true) :
 			Condition(id, type, 0, buff, subId, aggressive) {}
 
-		static void generateDamageList(int32_t amount, int32_t start, std::list<int32_t>& list);
+		static void generateDamageList(int32_t amount, int32_t start, std::vector<int32_t>& list);
 
 		bool startCondition(Creature* creature) override;
 		bool executeCondition(Creature* creature, int32_t interval) override;
@@ -289,7 +289,7 @@ class ConditionDamage final : public Condition {
 
 		bool init();
 
-		std::list<IntervalInfo> damageList;
+		std::vector<IntervalInfo> damageList;
 
 		bool getNextDamage(int32_t& damage);
 		bool doDamage(Creature* creature, int32_t healthChange);
@@ -96,6 +96,7 @@ namespace ConfigManager {
 		PROTECTION_LEVEL,
 		DEATH_LOSE_PERCENT,
 		STATUSQUERY_TIMEOUT,
+		STATUS_CACHE_TIME,
 		FRAG_TIME,
 		WHITE_SKULL_TIME,
 		GAME_PORT,
@@ -7,6 +7,7 @@
 
 #include "depotchest.h"
 #include "game.h"
+#include "house.h"
 #include "housetile.h"
 #include "inbox.h"
 #include "iomap.h"
@@ -164,13 +165,12 @@ std::string Container::getContentDescription() const {
 }
 
 std::ostringstream& Container::getContentDescription(std::ostringstream& os) const {
+	// listed level by level, the items of outer containers first
 	bool firstitem = true;
-	for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
-		Item* item = *it;
-
-		Container* container = item->getContainer();
+	visitItemsByLevel([&](const Item* item) {
+		const Container* container = item->getContainer();
 		if (container && !container->empty()) {
-			continue;
+			return false;
 		}
 
 		if (firstitem) {
@@ -180,7 +180,8 @@ std::ostringstream& Container::getContentDescription(std::ostringstream& os) con
 		}
 
 		os << item->getNameDescription();
-	}
+		return false;
+	});
 
 	if (firstitem) {
 		os << "nothing";
@@ -213,6 +214,8 @@ bool Container::isHoldingItem(const Item* item) const {
 }
 
 void Container::onAddContainerItem(Item* item) {
+	House::onItemChanged(this);
+
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, getPosition(), false, true, 1, 1, 1, 1);
 
@@ -230,6 +233,8 @@ void Container::onAddContainerItem(Item* item) {
 }
 
 void Container::onUpdateContainerItem(uint32_t index, Item* oldItem, Item* newItem) {
+	House::onItemChanged(this);
+
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, getPosition(), false, true, 1, 1, 1, 1);
 
@@ -247,6 +252,8 @@ void Container::onUpdateContainerItem(uint32_t index, Item* oldItem, Item* newIt
 }
 
 void Container::onRemoveContainerItem(uint32_t index, Item* item) {
+	House::onItemChanged(this);
+
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, getPosition(), false, true, 1, 1, 1, 1);
 
@@ -661,9 +668,10 @@ std::map<uint32_t, uint32_t>& Container::getAllItemTypeCount(std::map<uint32_t,
 ItemVector Container::getItems(bool recursive /*= false*/) {
 	ItemVector containerItems;
 	if (recursive) {
-		for (ContainerIterator it = iterator(); it.hasNext(); it.advance()) {
-			containerItems.push_back(*it);
-		}
+		visitItemsByLevel([&](Item* item) {
+			containerItems.push_back(item);
+			return false;
+		});
 	} else {
 		for (Item* item : itemlist) {
 			containerItems.push_back(item);
@@ -738,31 +746,28 @@ void Container::startDecaying() {
 ContainerIterator Container::iterator() const {
 	ContainerIterator cit;
 	if (!itemlist.empty()) {
-		cit.over.push_back(this);
-		cit.cur = itemlist.begin();
+		cit.over.emplace_back(this, itemlist.begin());
 	}
 	return cit;
 }
 
 Item* ContainerIterator::operator*() {
-	return *cur;
+	return *over.back().second;
 }
 
 void ContainerIterator::advance() {
-	if (Item* i = *cur) {
-		if (Container* c = i->getContainer()) {
+	// the container resumes after the current item once its contents are done
+	Item* i = *over.back().second++;
+	if (i) {
+		if (const Container* c = i->getContainer()) {
 			if (!c->empty()) {
-				over.push_back(c);
+				over.emplace_back(c, c->itemlist.begin());
+				return;
 			}
 		}
 	}
 
-	++cur;
-
-	if (cur == over.front()->itemlist.end()) {
-		over.pop_front();
-		if (!over.empty()) {
-			cur = over.front()->itemlist.begin();
-		}
+	while (!over.empty() && over.back().second == over.back().first->itemlist.end()) {
+		over.pop_back();
 	}
 }
\ No newline at end of file
@@ -12,6 +12,11 @@ class Container;
 class DepotLocker;
 class StoreInbox;
 
+/**
+ * Depth first iterator over the items inside a container and all its
+ * sub-containers. The path down to the current item is kept inline, so
+ * walking a container does not allocate unless it is nested very deep.
+ */
 class ContainerIterator {
 	public:
 		bool hasNext() const {
@@ -21,9 +26,13 @@ class ContainerIterator {
 		void advance();
 		Item* operator*();
 
+		// 0 for the items of the container the iteration started at
+		size_t getDepth() const {
+			return over.size() - 1;
+		}
+
 	private:
-		std::list<const Container*> over;
-		ItemDeque::const_iterator cur;
+		boost::container::small_vector<std::pair<const Container*, ItemDeque::const_iterator>, 8> over;
 
 		friend class Container;
 };
@@ -80,6 +89,27 @@ class Container : public Item, public Cylinder {
 
 		ContainerIterator iterator() const;
 
+		// visits the items level by level, the items of a container before the
+		// contents of its sub-containers; returning true from the visitor stops the walk
+		template<typename Visitor>
+		bool visitItemsByLevel(Visitor&& visitor) const {
+			boost::container::small_vector<const Container*, 8> containers {this};
+			for (size_t i = 0; i < containers.size(); ++i) {
+				for (Item* item : containers[i]->itemlist) {
+					if (visitor(item)) {
+						return true;
+					}
+
+					if (const Container* container = item->getContainer()) {
+						if (!container->empty()) {
+							containers.push_back(container);
+						}
+					}
+				}
+			}
+			return false;
+		}
+
 		const ItemDeque& getItemList() const {
 			return itemlist;
 		}
@@ -32,7 +32,9 @@ Creature::~Creature() {
 	}
 
 	for (Condition* condition : conditions) {
-		condition->endCondition(this);
+		if (condition) {
+			condition->endCondition(this);
+		}
 	}
 
 	for (auto condition : conditions) {
@@ -947,6 +949,7 @@ bool Creature::setMaster(Creature* newMaster) {
 
 	Creature* oldMaster = master;
 	master = newMaster;
+	g_game.map.creatureIndex.updateCreature(this);
 
 	if (oldMaster) {
 		auto summon = std::find(oldMaster->summons.begin(), oldMaster->summons.end(), this);
@@ -1001,11 +1004,10 @@ bool Creature::addCombatCondition(Condition* condition) {
 }
 
 void Creature::removeCondition(ConditionType_t type, bool force/* = false*/) {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		Condition* condition = *it;
-		if (condition->getType() != type) {
-			++it;
+	++conditionsWalkDepth;
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || condition->getType() != type) {
 			continue;
 		}
 
@@ -1013,25 +1015,26 @@ void Creature::removeCondition(ConditionType_t type, bool force/* = false*/) {
 			int64_t walkDelay = getWalkDelay();
 			if (walkDelay > 0) {
 				g_scheduler.addEvent(createSchedulerTask(walkDelay, [=, id = getID()] () { g_game.forceRemoveCondition(id, type); }));
-				return;
+				break;
 			}
 		}
 
-		it = conditions.erase(it);
+		conditions[i] = nullptr;
 
 		condition->endCondition(this);
 		delete condition;
 
 		onEndCondition(type);
 	}
+	--conditionsWalkDepth;
+	compactConditions();
 }
 
 void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId, bool force/* = false*/) {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		Condition* condition = *it;
-		if (condition->getType() != type || condition->getId() != conditionId) {
-			++it;
+	++conditionsWalkDepth;
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || condition->getType() != type || condition->getId() != conditionId) {
 			continue;
 		}
 
@@ -1039,23 +1042,25 @@ void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId,
 			int64_t walkDelay = getWalkDelay();
 			if (walkDelay > 0) {
 				g_scheduler.addEvent(createSchedulerTask(walkDelay, [=, id = getID()] () { g_game.forceRemoveCondition(id, type); }));
-				return;
+				break;
 			}
 		}
 
-		it = conditions.erase(it);
+		conditions[i] = nullptr;
 
 		condition->endCondition(this);
 		delete condition;
 
 		onEndCondition(type);
 	}
+	--conditionsWalkDepth;
+	compactConditions();
 }
 
 void Creature::removeCombatCondition(ConditionType_t type) {
 	std::vector<Condition*> removeConditions;
 	for (Condition* condition : conditions) {
-		if (condition->getType() == type) {
+		if (condition && condition->getType() == type) {
 			removeConditions.push_back(condition);
 		}
 	}
@@ -1079,16 +1084,42 @@ void Creature::removeCondition(Condition* condition, bool force/* = false*/) {
 		}
 	}
 
-	conditions.erase(it);
+	*it = nullptr;
 
 	condition->endCondition(this);
 	onEndCondition(condition->getType());
 	delete condition;
+
+	compactConditions();
+}
+
+void Creature::removePersistentConditions() {
+	++conditionsWalkDepth;
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || !condition->isPersistent()) {
+			continue;
+		}
+
+		conditions[i] = nullptr;
+
+		condition->endCondition(this);
+		onEndCondition(condition->getType());
+		delete condition;
+	}
+	--conditionsWalkDepth;
+	compactConditions();
+}
+
+void Creature::compactConditions() {
+	if (conditionsWalkDepth == 0) {
+		conditions.erase(std::remove(conditions.begin(), conditions.end(), nullptr), conditions.end());
+	}
 }
 
 Condition* Creature::getCondition(ConditionType_t type) const {
 	for (Condition* condition : conditions) {
-		if (condition->getType() == type) {
+		if (condition && condition->getType() == type) {
 			return condition;
 		}
 	}
@@ -1097,7 +1128,7 @@ Condition* Creature::getCondition(ConditionType_t type) const {
 
 Condition* Creature::getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId/* = 0*/) const {
 	for (Condition* condition : conditions) {
-		if (condition->getType() == type && condition->getId() == conditionId && condition->getSubId() == subId) {
+		if (condition && condition->getType() == type && condition->getId() == conditionId && condition->getSubId() == subId) {
 			return condition;
 		}
 	}
@@ -1105,23 +1136,24 @@ Condition* Creature::getCondition(ConditionType_t type, ConditionId_t conditionI
 }
 
 void Creature::executeConditions(uint32_t interval) {
-	ConditionList tempConditions{ conditions };
-	for (Condition* condition : tempConditions) {
-		auto it = std::find(conditions.begin(), conditions.end(), condition);
-		if (it == conditions.end()) {
+	// conditions added while ticking are appended and run from the next think on
+	++conditionsWalkDepth;
+	for (size_t i = 0, size = conditions.size(); i < size; ++i) {
+		Condition* condition = conditions[i];
+		if (!condition) {
 			continue;
 		}
 
-		if (!condition->executeCondition(this, interval)) {
-			it = std::find(conditions.begin(), conditions.end(), condition);
-			if (it != conditions.end()) {
-				conditions.erase(it);
-				condition->endCondition(this);
-				onEndCondition(condition->getType());
-				delete condition;
-			}
+		// the condition may have been removed by its own tick, e.g. through a script
+		if (!condition->executeCondition(this, interval) && conditions[i] == condition) {
+			conditions[i] = nullptr;
+			condition->endCondition(this);
+			onEndCondition(condition->getType());
+			delete condition;
 		}
 	}
+	--conditionsWalkDepth;
+	compactConditions();
 }
 
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const {
@@ -1131,7 +1163,7 @@ bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const
 
 	int64_t timeNow = OTSYS_TIME();
 	for (Condition* condition : conditions) {
-		if (condition->getType() != type || condition->getSubId() != subId) {
+		if (!condition || condition->getType() != type || condition->getSubId() != subId) {
 			continue;
 		}
 
@@ -1382,7 +1414,7 @@ bool FrozenPathingConditionCall::operator()(const Position& startPos, const Posi
 
 bool Creature::isInvisible() const {
 	return std::find_if(conditions.begin(), conditions.end(), [] (const Condition* condition) {
-		return condition->getType() == CONDITION_INVISIBLE;
+		return condition && condition->getType() == CONDITION_INVISIBLE;
 	}) != conditions.end();
 }
 
@@ -1403,7 +1435,7 @@ bool Creature::getPathTo(const Position& targetPos, std::vector<Direction>& dirL
 void Creature::setStorageValue(uint32_t key, std::optional<int32_t> value, bool isSpawn) {
 	auto oldValue = getStorageValue(key);
 	if (value) {
-		storageMap.insert_or_assign(key, value.value());
+		storageMap.set(key, value.value());
 	} else {
 		storageMap.erase(key);
 	}
@@ -1411,9 +1443,5 @@ void Creature::setStorageValue(uint32_t key, std::optional<int32_t> value, bool
 }
 
 std::optional<int32_t> Creature::getStorageValue(uint32_t key) const {
-	auto it = storageMap.find(key);
-	if (it == storageMap.end()) {
-		return std::nullopt;
-	}
-	return std::make_optional(it->second);
+	return storageMap.get(key);
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "enums.h"
 #include "map.h"
 #include "position.h"
+#include "storagemap.h"
 #include "tile.h"
 
 class Condition;
@@ -18,7 +19,7 @@ class Monster;
 class Npc;
 class Player;
 
-using ConditionList = std::list<Condition*>;
+using ConditionList = std::vector<Condition*>;
 using CreatureEventList = std::list<CreatureEvent*>;
 
 enum slots_t : uint8_t {
@@ -482,7 +483,7 @@ class Creature : virtual public Thing {
 
 		virtual void setStorageValue(uint32_t key, std::optional<int32_t> value, bool isSpawn = false);
 		virtual std::optional<int32_t> getStorageValue(uint32_t key) const;
-		decltype(auto) getStorageMap() const {
+		const StorageMap& getStorageMap() const {
 			return storageMap;
 		}
 
@@ -499,7 +500,10 @@ class Creature : virtual public Thing {
 
 		std::list<Creature*> summons;
 		CreatureEventList eventsList;
+		// conditions removed while the list is being walked leave an empty slot,
+		// the list is compacted once the outermost walk is done
 		ConditionList conditions;
+		uint32_t conditionsWalkDepth = 0;
 
 		std::vector<Direction> listWalkDir;
 
@@ -553,6 +557,8 @@ class Creature : virtual public Thing {
 		}
 		CreatureEventList getCreatureEvents(CreatureEventType_t type);
 
+		void removePersistentConditions();
+
 		void onCreatureDisappear(const Creature* creature, bool isLogout);
 		virtual void doAttacking(uint32_t) {}
 		virtual bool hasExtraSwing() {
@@ -576,7 +582,9 @@ class Creature : virtual public Thing {
 		friend class LuaScriptInterface;
 
 	private:
-		std::map<uint32_t, int32_t> storageMap;
+		void compactConditions();
+
+		StorageMap storageMap;
 };
 
 #endif // FS_CREATURE_H
\ No newline at end of file
@@ -0,0 +1,139 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "creatureindex.h"
+
+#include "creature.h"
+#include "spectators.h"
+
+namespace {
+
+uint8_t getCreatureType(const Creature* creature) {
+	uint8_t type = 0;
+	if (creature->getPlayer()) {
+		type |= CREATUREINDEX_PLAYER;
+	} else if (creature->getMonster()) {
+		type |= CREATUREINDEX_MONSTER;
+	} else if (creature->getNpc()) {
+		type |= CREATUREINDEX_NPC;
+	}
+
+	if (creature->isSummon()) {
+		type |= CREATUREINDEX_SUMMON;
+	}
+	return type;
+}
+
+}
+
+void CreatureIndex::addCreature(Creature* creature, const Position& pos) {
+	auto [it, inserted] = slots.try_emplace(creature);
+	if (!inserted) {
+		erase(it->second);
+	}
+	insert(creature, it->second, pos, getCreatureType(creature));
+}
+
+void CreatureIndex::removeCreature(Creature* creature) {
+	auto it = slots.find(creature);
+	if (it == slots.end()) {
+		return;
+	}
+
+	erase(it->second);
+	slots.erase(it);
+}
+
+void CreatureIndex::moveCreature(Creature* creature, const Position& newPos) {
+	auto it = slots.find(creature);
+	if (it == slots.end()) {
+		return;
+	}
+
+	Slot& slot = it->second;
+	if (slot.cell == getCellKey(newPos.x, newPos.y, newPos.z)) {
+		cells[slot.cell].positions[slot.index] = newPos;
+		return;
+	}
+
+	const uint8_t type = cells[slot.cell].types[slot.index];
+	erase(slot);
+	insert(creature, slot, newPos, type);
+}
+
+void CreatureIndex::updateCreature(Creature* creature) {
+	auto it = slots.find(creature);
+	if (it == slots.end()) {
+		return;
+	}
+
+	const Slot& slot = it->second;
+	cells[slot.cell].types[slot.index] = getCreatureType(creature);
+}
+
+void CreatureIndex::getCreatures(SpectatorVec& spectators, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, uint8_t z, uint8_t types/* = CREATUREINDEX_ALL*/) const {
+	minX = std::max<int32_t>(minX, 0);
+	minY = std::max<int32_t>(minY, 0);
+	maxX = std::min<int32_t>(maxX, std::numeric_limits<uint16_t>::max());
+	maxY = std::min<int32_t>(maxY, std::numeric_limits<uint16_t>::max());
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+
+	for (int32_t cellX = minX >> CELL_BITS, endX = maxX >> CELL_BITS; cellX <= endX; ++cellX) {
+		for (int32_t cellY = minY >> CELL_BITS, endY = maxY >> CELL_BITS; cellY <= endY; ++cellY) {
+			auto it = cells.find(getCellKey(cellX << CELL_BITS, cellY << CELL_BITS, z));
+			if (it == cells.end()) {
+				continue;
+			}
+
+			const Cell& cell = it->second;
+			for (size_t i = 0, size = cell.positions.size(); i < size; ++i) {
+				if ((cell.types[i] & types) == 0) {
+					continue;
+				}
+
+				const Position& pos = cell.positions[i];
+				if (pos.x < minX || pos.x > maxX || pos.y < minY || pos.y > maxY) {
+					continue;
+				}
+
+				spectators.emplace_back(cell.creatures[i]);
+			}
+		}
+	}
+}
+
+void CreatureIndex::insert(Creature* creature, Slot& slot, const Position& pos, uint8_t type) {
+	slot.cell = getCellKey(pos.x, pos.y, pos.z);
+
+	Cell& cell = cells[slot.cell];
+	slot.index = cell.creatures.size();
+	cell.creatures.push_back(creature);
+	cell.positions.push_back(pos);
+	cell.types.push_back(type);
+}
+
+void CreatureIndex::erase(const Slot& slot) {
+	auto it = cells.find(slot.cell);
+	Cell& cell = it->second;
+	if (cell.creatures.size() == 1) {
+		cells.erase(it);
+		return;
+	}
+
+	// swap with the last entry, which then takes over the freed index
+	const uint32_t last = cell.creatures.size() - 1;
+	if (slot.index != last) {
+		cell.creatures[slot.index] = cell.creatures[last];
+		cell.positions[slot.index] = cell.positions[last];
+		cell.types[slot.index] = cell.types[last];
+		slots[cell.creatures[slot.index]].index = slot.index;
+	}
+
+	cell.creatures.pop_back();
+	cell.positions.pop_back();
+	cell.types.pop_back();
+}
@@ -0,0 +1,77 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_CREATUREINDEX_H
+#define FS_CREATUREINDEX_H
+
+#include "position.h"
+
+class Creature;
+class SpectatorVec;
+
+enum CreatureIndexType_t : uint8_t {
+	CREATUREINDEX_PLAYER = 1 << 0,
+	CREATUREINDEX_MONSTER = 1 << 1,
+	CREATUREINDEX_NPC = 1 << 2,
+	CREATUREINDEX_SUMMON = 1 << 3,
+
+	CREATUREINDEX_ALL = CREATUREINDEX_PLAYER | CREATUREINDEX_MONSTER | CREATUREINDEX_NPC | CREATUREINDEX_SUMMON,
+};
+
+/**
+ * Spatial index of the creatures on the map, a sparse uniform grid per floor.
+ * Queries only read the positions and types stored in the cells and never
+ * touch the creatures themselves, so the index can be guarded on its own if
+ * it ever has to be read outside the dispatcher.
+ */
+class CreatureIndex {
+	public:
+		static constexpr int32_t CELL_BITS = 4;
+
+		CreatureIndex() = default;
+
+		// non-copyable
+		CreatureIndex(const CreatureIndex&) = delete;
+		CreatureIndex& operator=(const CreatureIndex&) = delete;
+
+		void addCreature(Creature* creature, const Position& pos);
+		void removeCreature(Creature* creature);
+		void moveCreature(Creature* creature, const Position& newPos);
+
+		// refreshes the type of an indexed creature, e.g. after it became a summon
+		void updateCreature(Creature* creature);
+
+		// appends the creatures of the given types inside [minX, maxX] x [minY, maxY] on floor z
+		void getCreatures(SpectatorVec& spectators, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, uint8_t z, uint8_t types = CREATUREINDEX_ALL) const;
+		void getCreatures(SpectatorVec& spectators, const Position& centerPos, int32_t radius, uint8_t types = CREATUREINDEX_ALL) const {
+			getCreatures(spectators, centerPos.x - radius, centerPos.y - radius, centerPos.x + radius, centerPos.y + radius, centerPos.z, types);
+		}
+
+		size_t size() const {
+			return slots.size();
+		}
+
+	private:
+		struct Cell {
+			std::vector<Creature*> creatures;
+			std::vector<Position> positions;
+			std::vector<uint8_t> types;
+		};
+
+		struct Slot {
+			uint64_t cell;
+			uint32_t index;
+		};
+
+		static uint64_t getCellKey(uint16_t x, uint16_t y, uint8_t z) {
+			return (static_cast<uint64_t>(z) << 32) | (static_cast<uint64_t>(x >> CELL_BITS) << 16) | (y >> CELL_BITS);
+		}
+
+		void insert(Creature* creature, Slot& slot, const Position& pos, uint8_t type);
+		void erase(const Slot& slot);
+
+		std::unordered_map<uint64_t, Cell> cells;
+		std::unordered_map<const Creature*, Slot> slots;
+};
+
+#endif // FS_CREATUREINDEX_H
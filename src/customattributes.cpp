@@ -0,0 +1,53 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "customattributes.h"
+
+#include "pugicast.h"
+#include "tools.h"
+
+bool CustomAttributes::reload() {
+	attributes.clear();
+	return loadFromXml();
+}
+
+bool CustomAttributes::loadFromXml() {
+	pugi::xml_document doc;
+	pugi::xml_parse_result result = doc.load_file("data/XML/custom_attributes.xml");
+	if (!result) {
+		printXMLError("Error - CustomAttributes::loadFromXml", "data/XML/custom_attributes.xml", result);
+		return false;
+	}
+
+	for (auto attributeNode : doc.child("attributes").children()) {
+		uint32_t nodeId = pugi::cast<uint32_t>(attributeNode.attribute("id").value());
+		if (nodeId == 0 || nodeId > CUSTOMATTRIBUTE_LAST) {
+			std::cout << "[Notice - CustomAttributes::loadFromXml] Attribute id \"" << nodeId << "\" is not within 1 and " << CUSTOMATTRIBUTE_LAST << " range" << std::endl;
+			continue;
+		}
+
+		if (getAttribute(nodeId)) {
+			std::cout << "[Notice - CustomAttributes::loadFromXml] Duplicate attribute with id: " << nodeId << std::endl;
+			continue;
+		}
+
+		attributes.emplace_back(
+			static_cast<uint16_t>(nodeId),
+			attributeNode.attribute("name").as_string(),
+			attributeNode.attribute("description").as_string(),
+			attributeNode.attribute("group").as_string()
+		);
+	}
+	attributes.shrink_to_fit();
+	return true;
+}
+
+const CustomAttribute* CustomAttributes::getAttribute(uint16_t id) const {
+	auto it = std::find_if(attributes.begin(), attributes.end(), [id](const CustomAttribute& attribute) {
+		return attribute.id == id;
+	});
+
+	return it != attributes.end() ? &*it : nullptr;
+}
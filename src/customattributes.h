@@ -0,0 +1,45 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_CUSTOMATTRIBUTES_H
+#define FS_CUSTOMATTRIBUTES_H
+
+// attributes the server evaluates itself, the others are only read by scripts
+enum CustomAttributeId_t : uint16_t {
+	CUSTOMATTRIBUTE_BLOCK_CHANCE = 2,
+	CUSTOMATTRIBUTE_PARRY_CHANCE = 3,
+	CUSTOMATTRIBUTE_DODGE_CHANCE = 4,
+	CUSTOMATTRIBUTE_REFLECT_DAMAGE = 5,
+	CUSTOMATTRIBUTE_SPELL_POWER = 11,
+
+	CUSTOMATTRIBUTE_LAST = 63,
+};
+
+// base values given by scripts are saved in the storage key storage base + id
+static constexpr uint32_t CUSTOMATTRIBUTE_STORAGE_BASE = 220000;
+
+struct CustomAttribute {
+	CustomAttribute(uint16_t id, std::string name, std::string description, std::string group) :
+		name(std::move(name)), description(std::move(description)), group(std::move(group)), id(id) {}
+
+	std::string name;
+	std::string description;
+	std::string group;
+	uint16_t id;
+};
+
+class CustomAttributes {
+	public:
+		bool reload();
+		bool loadFromXml();
+		const CustomAttribute* getAttribute(uint16_t id) const;
+
+		const std::vector<CustomAttribute>& getAttributes() const {
+			return attributes;
+		}
+
+	private:
+		std::vector<CustomAttribute> attributes;
+};
+
+#endif // FS_CUSTOMATTRIBUTES_H
@@ -0,0 +1,52 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "customskills.h"
+
+#include "pugicast.h"
+#include "tools.h"
+
+bool CustomSkills::reload() {
+	skills.clear();
+	return loadFromXml();
+}
+
+bool CustomSkills::loadFromXml() {
+	pugi::xml_document doc;
+	pugi::xml_parse_result result = doc.load_file("data/XML/custom_skills.xml");
+	if (!result) {
+		printXMLError("Error - CustomSkills::loadFromXml", "data/XML/custom_skills.xml", result);
+		return false;
+	}
+
+	for (auto skillNode : doc.child("customskills").children()) {
+		uint32_t nodeId = pugi::cast<uint32_t>(skillNode.attribute("id").value());
+		if (nodeId == 0 || nodeId > CUSTOMSKILL_LAST) {
+			std::cout << "[Notice - CustomSkills::loadFromXml] Skill id \"" << nodeId << "\" is not within 1 and " << CUSTOMSKILL_LAST << " range" << std::endl;
+			continue;
+		}
+
+		if (getSkill(nodeId)) {
+			std::cout << "[Notice - CustomSkills::loadFromXml] Duplicate skill with id: " << nodeId << std::endl;
+			continue;
+		}
+
+		skills.emplace_back(
+			static_cast<uint16_t>(nodeId),
+			skillNode.attribute("name").as_string(),
+			skillNode.attribute("description").as_string()
+		);
+	}
+	skills.shrink_to_fit();
+	return true;
+}
+
+const CustomSkill* CustomSkills::getSkill(uint16_t id) const {
+	auto it = std::find_if(skills.begin(), skills.end(), [id](const CustomSkill& skill) {
+		return skill.id == id;
+	});
+
+	return it != skills.end() ? &*it : nullptr;
+}
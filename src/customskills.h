@@ -0,0 +1,32 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_CUSTOMSKILLS_H
+#define FS_CUSTOMSKILLS_H
+
+static constexpr uint16_t CUSTOMSKILL_LAST = 31;
+
+struct CustomSkill {
+	CustomSkill(uint16_t id, std::string name, std::string description) :
+		name(std::move(name)), description(std::move(description)), id(id) {}
+
+	std::string name;
+	std::string description;
+	uint16_t id;
+};
+
+class CustomSkills {
+	public:
+		bool reload();
+		bool loadFromXml();
+		const CustomSkill* getSkill(uint16_t id) const;
+
+		const std::vector<CustomSkill>& getSkills() const {
+			return skills;
+		}
+
+	private:
+		std::vector<CustomSkill> skills;
+};
+
+#endif // FS_CUSTOMSKILLS_H
@@ -143,22 +143,23 @@ DBResult_ptr Database::storeQuery(std::string_view query) {
 }
 
 std::string Database::escapeBlob(const char* s, uint32_t length) const {
-	// the worst case is 2n + 1
-	size_t maxLength = (length * 2) + 1;
-
 	std::string escaped;
-	escaped.reserve(maxLength + 2);
-	escaped.push_back('\'');
+	appendEscapedBlob(escaped, s, length);
+	return escaped;
+}
 
+void Database::appendEscapedBlob(std::string& query, const char* s, uint32_t length) const {
+	// the worst case is 2n + 1, escaped in place between the quotes
+	const size_t offset = query.length();
+	query.resize(offset + (length * 2) + 3, '\'');
+
+	size_t escapedLength = 0;
 	if (length != 0) {
-		char* output = new char[maxLength];
-		mysql_real_escape_string(handle.get(), output, s, length);
-		escaped.append(output);
-		delete[] output;
+		escapedLength = mysql_real_escape_string(handle.get(), query.data() + offset + 1, s, length);
 	}
 
-	escaped.push_back('\'');
-	return escaped;
+	query[offset + escapedLength + 1] = '\'';
+	query.resize(offset + escapedLength + 2);
 }
 
 DBResult::DBResult(detail::MysqlResult_ptr&& res) : handle {std::move(res)} {
@@ -197,30 +198,45 @@ bool DBResult::next() {
 	return row;
 }
 
-DBInsert::DBInsert(std::string query) : query(std::move(query)) {
-	this->length = this->query.length();
+DBInsert::DBInsert(std::string query, std::string suffix/* = ""*/, Database& db/* = Database::getInstance()*/) :
+	db(db), query(std::move(query)), suffix(std::move(suffix)) {
+	this->length = this->query.length() + this->suffix.length();
+	this->prefixLength = this->query.length();
 }
 
 bool DBInsert::addRow(const std::string& row) {
-	// adds new row to buffer
+	// adds new row to buffer, the values are appended to the query itself so
+	// executing does not copy them again
 	const size_t rowLength = row.length();
 	length += rowLength;
-	if (length > Database::getInstance().getMaxPacketSize() && !execute()) {
+	if (length > db.getMaxPacketSize() && !execute()) {
+		return false;
+	}
+
+	if (query.length() != prefixLength) {
+		query.push_back(',');
+	}
+	query.push_back('(');
+	query.append(row);
+	query.push_back(')');
+	return true;
+}
+
+bool DBInsert::addRow(std::string_view values, std::string_view blob) {
+	// the escaped blob is at most twice as long plus its quotes
+	length += values.length() + (blob.length() * 2) + 4;
+	if (length > db.getMaxPacketSize() && !execute()) {
 		return false;
 	}
 
-	if (values.empty()) {
-		values.reserve(rowLength + 2);
-		values.push_back('(');
-		values.append(row);
-		values.push_back(')');
-	} else {
-		values.reserve(values.length() + rowLength + 3);
-		values.push_back(',');
-		values.push_back('(');
-		values.append(row);
-		values.push_back(')');
+	if (query.length() != prefixLength) {
+		query.push_back(',');
 	}
+	query.push_back('(');
+	query.append(values);
+	query.append(", ");
+	db.appendEscapedBlob(query, blob.data(), blob.length());
+	query.push_back(')');
 	return true;
 }
 
@@ -231,13 +247,14 @@ bool DBInsert::addRow(std::ostringstream& row) {
 }
 
 bool DBInsert::execute() {
-	if (values.empty()) {
+	if (query.length() == prefixLength) {
 		return true;
 	}
 
 	// executes buffer
-	bool res = Database::getInstance().executeQuery(query + values);
-	values.clear();
-	length = query.length();
+	query.append(suffix);
+	bool res = db.executeQuery(query);
+	query.resize(prefixLength);
+	length = prefixLength + suffix.length();
 	return res;
 }
\ No newline at end of file
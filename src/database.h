@@ -83,6 +83,15 @@ class Database {
 		 */
 		std::string escapeBlob(const char* s, uint32_t length) const;
 
+		/**
+		 * Escapes binary stream for query and appends it to the query.
+		 *
+		 * @param query query the quoted stream is appended to
+		 * @param s binary stream
+		 * @param length stream length
+		 */
+		void appendEscapedBlob(std::string& query, const char* s, uint32_t length) const;
+
 		/**
 		 * Retrieve id of last inserted row
 		 *
@@ -168,24 +177,29 @@ class DBResult {
 */
 class DBInsert {
 	public:
-		explicit DBInsert(std::string query);
+		// the suffix is appended to every executed statement, e.g. an ON DUPLICATE KEY clause
+		explicit DBInsert(std::string query, std::string suffix = "", Database& db = Database::getInstance());
 		bool addRow(const std::string& row);
 		bool addRow(std::ostringstream& row);
+		// appends a row ending with a binary blob that is escaped straight into the query
+		bool addRow(std::string_view values, std::string_view blob);
 		bool execute();
 
 	private:
+		Database& db;
 		std::string query;
-		std::string values;
+		std::string suffix;
+		size_t prefixLength;
 		size_t length;
 };
 
 class DBTransaction {
 	public:
-		constexpr DBTransaction() = default;
+		explicit DBTransaction(Database& db = Database::getInstance()) : db(db) {}
 
 		~DBTransaction() {
 			if (state == STATE_START) {
-				Database::getInstance().rollback();
+				db.rollback();
 			}
 		}
 
@@ -195,7 +209,7 @@ class DBTransaction {
 
 		bool begin() {
 			state = STATE_START;
-			return Database::getInstance().beginTransaction();
+			return db.beginTransaction();
 		}
 
 		bool commit() {
@@ -204,7 +218,7 @@ class DBTransaction {
 			}
 
 			state = STATE_COMMIT;
-			return Database::getInstance().commit();
+			return db.commit();
 		}
 
 	private:
@@ -214,6 +228,7 @@ class DBTransaction {
 			STATE_COMMIT,
 		};
 
+		Database& db;
 		TransactionStates_t state = STATE_NO_START;
 };
 
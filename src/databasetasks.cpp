@@ -47,7 +47,29 @@ void DatabaseTasks::addTask(std::string query, std::function<void(DBResult_ptr,
 	}
 }
 
+bool DatabaseTasks::addJob(std::function<void(Database&)> job) {
+	bool added = false;
+	bool signal = false;
+	taskLock.lock();
+	if (getState() == THREAD_STATE_RUNNING) {
+		signal = tasks.empty();
+		tasks.emplace_back(std::move(job));
+		added = true;
+	}
+	taskLock.unlock();
+
+	if (signal) {
+		taskSignal.notify_one();
+	}
+	return added;
+}
+
 void DatabaseTasks::runTask(const DatabaseTask& task) {
+	if (task.job) {
+		task.job(db);
+		return;
+	}
+
 	bool success;
 	DBResult_ptr result;
 	if (task.store) {
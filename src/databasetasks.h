@@ -11,10 +11,14 @@
 struct DatabaseTask {
 	DatabaseTask(std::string&& query, std::function<void(DBResult_ptr, bool)>&& callback, bool store) :
 		query(std::move(query)), callback(std::move(callback)), store(store) {}
+	explicit DatabaseTask(std::function<void(Database&)>&& job) : job(std::move(job)) {}
 
 	std::string query;
 	std::function<void(DBResult_ptr, bool)> callback;
-	bool store;
+	// runs on the database thread instead of a query, using its connection,
+	// it has to hand its result back to the dispatcher on its own
+	std::function<void(Database&)> job;
+	bool store = false;
 };
 
 class DatabaseTasks : public ThreadHolder<DatabaseTasks> {
@@ -25,6 +29,7 @@ class DatabaseTasks : public ThreadHolder<DatabaseTasks> {
 		void shutdown();
 
 		void addTask(std::string query, std::function<void(DBResult_ptr, bool)> callback = nullptr, bool store = false);
+		bool addJob(std::function<void(Database&)> job);
 
 		void threadMain();
 	private:
@@ -117,13 +117,16 @@ class PropWriteStream {
 			buffer.clear();
 		}
 
+		// the buffer keeps its capacity across clear(), so a stream reused for
+		// many objects stops allocating once it has grown to the largest one
 		template <typename T>
 		void write(T add) {
-			char* addr = reinterpret_cast<char*>(&add);
-			std::copy(addr, addr + sizeof(T), std::back_inserter(buffer));
+			const size_t size = buffer.size();
+			buffer.resize(size + sizeof(T));
+			memcpy(buffer.data() + size, &add, sizeof(T));
 		}
 
-		void writeString(const std::string& str) {
+		void writeString(std::string_view str) {
 			size_t strLength = str.size();
 			if (strLength > std::numeric_limits<uint16_t>::max()) {
 				write<uint16_t>(0);
@@ -131,7 +134,7 @@ class PropWriteStream {
 			}
 
 			write(static_cast<uint16_t>(strLength));
-			std::copy(str.begin(), str.end(), std::back_inserter(buffer));
+			buffer.insert(buffer.end(), str.begin(), str.end());
 		}
 
 	private:
@@ -45,6 +45,29 @@ extern MoveEvents* g_moveEvents;
 extern Weapons* g_weapons;
 extern Scripts* g_scripts;
 
+uint64_t Game::broadcastEncodesSaved = 0;
+
+namespace {
+
+// copies a message that was encoded once to every spectator player the filter accepts
+template <typename Filter>
+void sendToSpectators(const SpectatorVec& spectators, const NetworkMessage& msg, Filter&& filter) {
+	uint64_t receivers = 0;
+	for (Creature* spectator : spectators) {
+		Player* spectatorPlayer = spectator->getPlayer();
+		if (spectatorPlayer && filter(spectatorPlayer)) {
+			spectatorPlayer->sendNetworkMessage(msg);
+			++receivers;
+		}
+	}
+
+	if (receivers > 1) {
+		Game::broadcastEncodesSaved += receivers - 1;
+	}
+}
+
+}
+
 Game::Game() {
 	offlineTrainingWindow.defaultEnterButton = 0;
 	offlineTrainingWindow.defaultEscapeButton = 1;
@@ -185,7 +208,18 @@ void Game::saveGameState() {
 		IOLoginData::savePlayer(it.second);
 	}
 
-	Map::save();
+	if (gameState == GAME_STATE_SHUTDOWN) {
+		// the database thread and the dispatcher stop right after this save
+		if (!Map::save()) {
+			std::cout << "[Error - Game::saveGameState] Failed to save houses." << std::endl;
+		}
+	} else if (!Map::save([](bool saved) {
+		if (!saved) {
+			std::cout << "[Error - Game::saveGameState] Failed to save house items." << std::endl;
+		}
+	})) {
+		std::cout << "[Error - Game::saveGameState] Failed to save houses." << std::endl;
+	}
 
 	g_databaseTasks.flush();
 
@@ -1746,13 +1780,17 @@ ReturnValue Game::internalTeleport(Thing* thing, const Position& newPos, bool pu
 }
 
 Item* searchForItem(Container* container, uint16_t itemId) {
-	for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-		if ((*it)->getID() == itemId) {
-			return *it;
+	// the shallowest match wins
+	Item* found = nullptr;
+	container->visitItemsByLevel([&](Item* item) {
+		if (item->getID() != itemId) {
+			return false;
 		}
-	}
 
-	return nullptr;
+		found = item;
+		return true;
+	});
+	return found;
 }
 
 slots_t getSlotType(const ItemType& it) {
@@ -1935,7 +1973,7 @@ void Game::playerOpenChannel(uint32_t playerId, uint16_t channelId) {
 	}
 
 	const InvitedMap* invitedUsers = channel->getInvitedUsers();
-	const UsersMap* users;
+	const UserList* users;
 	if (!channel->isPublicChannel()) {
 		users = &channel->getUsers();
 	} else {
@@ -2416,6 +2454,7 @@ void Game::playerWriteItem(uint32_t playerId, uint32_t windowTextId, std::string
 		writeItem->resetWriter();
 		writeItem->resetDate();
 	}
+	House::onItemChanged(writeItem);
 
 	uint16_t newId = Item::items[writeItem->getID()].writeOnceItemId;
 	if (newId != 0) {
@@ -3610,13 +3649,11 @@ bool Game::internalCreatureSay(Creature* creature, SpeakClasses type, const std:
 	}
 
 	//send to client
-	for (Creature* spectator : spectators) {
-		if (Player* tmpPlayer = spectator->getPlayer()) {
-			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
-			}
-		}
-	}
+	NetworkMessage msg;
+	ProtocolGame::AddCreatureSay(msg, creature, type, text, *pos);
+	sendToSpectators(spectators, msg, [=](const Player* player) {
+		return !ghostMode || player->canSeeCreature(creature);
+	});
 
 	//event method
 	if (!echo) {
@@ -3810,6 +3847,31 @@ bool Game::combatBlockHit(CombatDamage& damage, Creature* attacker, Creature* ta
 		}
 	};
 
+	// custom attributes only act on attacks, never on conditions or healing
+	const bool attributesApply = attacker && damage.origin != ORIGIN_CONDITION && damage.primary.type != COMBAT_HEALING;
+	if (attributesApply) {
+		if (Player* targetPlayer = target->getPlayer()) {
+			if (targetPlayer->rollCustomAttribute(CUSTOMATTRIBUTE_DODGE_CHANCE)) {
+				sendBlockEffect(BLOCK_DEFENSE, damage.primary.type, target->getPosition());
+				damage.blockType = BLOCK_DEFENSE;
+				return true;
+			}
+
+			if (targetPlayer->rollCustomAttribute(CUSTOMATTRIBUTE_BLOCK_CHANCE)) {
+				sendBlockEffect(BLOCK_ARMOR, damage.primary.type, target->getPosition());
+				damage.blockType = BLOCK_ARMOR;
+				return true;
+			}
+		}
+
+		if (Player* attackerPlayer = attacker->getPlayer(); attackerPlayer && damage.origin == ORIGIN_SPELL) {
+			if (int32_t spellPower = attackerPlayer->getCustomAttribute(CUSTOMATTRIBUTE_SPELL_POWER); spellPower > 0) {
+				damage.primary.value += damage.primary.value * spellPower / 100;
+				damage.secondary.value += damage.secondary.value * spellPower / 100;
+			}
+		}
+	}
+
 	BlockType_t primaryBlockType, secondaryBlockType;
 	if (damage.primary.type != COMBAT_NONE) {
 		damage.primary.value = std::abs(damage.primary.value);
@@ -3836,6 +3898,15 @@ bool Game::combatBlockHit(CombatDamage& damage, Creature* attacker, Creature* ta
 
 	damage.blockType = primaryBlockType;
 
+	// a parry halves what is left of a melee hit
+	if (attributesApply && checkDefense && damage.origin == ORIGIN_MELEE && primaryBlockType == BLOCK_NONE) {
+		Player* targetPlayer = target->getPlayer();
+		if (targetPlayer && targetPlayer->rollCustomAttribute(CUSTOMATTRIBUTE_PARRY_CHANCE)) {
+			damage.primary.value /= 2;
+			sendBlockEffect(BLOCK_ARMOR, damage.primary.type, target->getPosition());
+		}
+	}
+
 	return (primaryBlockType != BLOCK_NONE) && (secondaryBlockType != BLOCK_NONE);
 }
 
@@ -3953,6 +4024,13 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 			return false;
 		}
 
+		// healing does not go through combatBlockHit, so spell power is applied here
+		if (attackerPlayer && damage.origin == ORIGIN_SPELL) {
+			if (int32_t spellPower = attackerPlayer->getCustomAttribute(CUSTOMATTRIBUTE_SPELL_POWER); spellPower > 0) {
+				damage.primary.value += damage.primary.value * spellPower / 100;
+			}
+		}
+
 		if (damage.origin != ORIGIN_NONE) {
 			const auto& events = target->getCreatureEvents(CREATURE_EVENT_HEALTHCHANGE);
 			if (!events.empty()) {
@@ -4015,7 +4093,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 	} else {
 		if (!target->isAttackable()) {
 			if (!target->isInGhostMode()) {
-				addMagicEffect(targetPos, CONST_ME_POFF);
+				addCombatMagicEffect(targetPos, CONST_ME_POFF);
 			}
 			return true;
 		}
@@ -4040,6 +4118,11 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 			return true;
 		}
 
+		// reflected damage has no origin, so it is never reflected back and the
+		// health change events re-entering this function with ORIGIN_NONE skip it too
+		const bool reflectable = targetPlayer && attacker && attacker != target && damage.origin != ORIGIN_NONE && damage.origin != ORIGIN_CONDITION;
+		const uint32_t attackerId = attacker ? attacker->getID() : 0;
+
 		TextMessage message;
 		message.position = targetPos;
 
@@ -4063,7 +4146,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 
 				targetPlayer->drainMana(attacker, manaDamage);
 				map.getSpectators(spectators, targetPos, true, true);
-				addMagicEffect(spectators, targetPos, CONST_ME_LOSEENERGY);
+				addCombatMagicEffect(spectators, targetPos, CONST_ME_LOSEENERGY);
 
 				std::string spectatorMessage;
 
@@ -4127,7 +4210,15 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 					creatureEvent->executeHealthChange(target, attacker, damage);
 				}
 				damage.origin = ORIGIN_NONE;
-				return combatChangeHealth(attacker, target, damage);
+				if (!combatChangeHealth(attacker, target, damage)) {
+					return false;
+				}
+
+				// the damage now holds what the nested call dealt
+				if (reflectable) {
+					reflectDamage(attackerId, target, damage, damage.primary.value + damage.secondary.value);
+				}
+				return true;
 			}
 		}
 
@@ -4155,14 +4246,14 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 		if (message.primary.value) {
 			combatGetTypeInfo(damage.primary.type, target, message.primary.color, hitEffect);
 			if (hitEffect != CONST_ME_NONE) {
-				addMagicEffect(spectators, targetPos, hitEffect);
+				addCombatMagicEffect(spectators, targetPos, hitEffect);
 			}
 		}
 
 		if (message.secondary.value) {
 			combatGetTypeInfo(damage.secondary.type, target, message.secondary.color, hitEffect);
 			if (hitEffect != CONST_ME_NONE) {
-				addMagicEffect(spectators, targetPos, hitEffect);
+				addCombatMagicEffect(spectators, targetPos, hitEffect);
 			}
 		}
 
@@ -4218,12 +4309,43 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 		}
 
 		target->drainHealth(attacker, realDamage);
-		addCreatureHealth(spectators, target);
+		if (!bufferCreatureHealth(target)) {
+			addCreatureHealth(spectators, target);
+		}
+
+		if (reflectable) {
+			reflectDamage(attackerId, target, damage, realDamage);
+		}
 	}
 
 	return true;
 }
 
+void Game::reflectDamage(uint32_t attackerId, Creature* target, const CombatDamage& damage, int32_t realDamage) {
+	const Player* targetPlayer = target->getPlayer();
+	if (!targetPlayer) {
+		return;
+	}
+
+	int32_t reflect = targetPlayer->getCustomAttribute(CUSTOMATTRIBUTE_REFLECT_DAMAGE);
+	if (reflect <= 0) {
+		return;
+	}
+
+	// the target's death may have removed the attacker
+	Creature* attacker = getCreatureByID(attackerId);
+	if (!attacker || attacker->isRemoved()) {
+		return;
+	}
+
+	CombatDamage reflectDamage;
+	reflectDamage.primary.type = damage.primary.type;
+	reflectDamage.primary.value = -(realDamage * reflect / 100);
+	if (reflectDamage.primary.value != 0) {
+		combatChangeHealth(target->isRemoved() ? nullptr : target, attacker, reflectDamage);
+	}
+}
+
 bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage& damage) {
 	Player* targetPlayer = target->getPlayer();
 	if (!targetPlayer) {
@@ -4265,7 +4387,7 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 		const Position& targetPos = target->getPosition();
 		if (!target->isAttackable()) {
 			if (!target->isInGhostMode()) {
-				addMagicEffect(targetPos, CONST_ME_POFF);
+				addCombatMagicEffect(targetPos, CONST_ME_POFF);
 			}
 			return false;
 		}
@@ -4358,11 +4480,9 @@ void Game::addCreatureHealth(const Creature* target) {
 }
 
 void Game::addCreatureHealth(const SpectatorVec& spectators, const Creature* target) {
-	for (Creature* spectator : spectators) {
-		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
-		}
-	}
+	NetworkMessage msg;
+	ProtocolGame::AddCreatureHealth(msg, target);
+	sendToSpectators(spectators, msg, [](const Player*) { return true; });
 }
 
 void Game::addMagicEffect(const Position& pos, uint8_t effect) {
@@ -4372,11 +4492,114 @@ void Game::addMagicEffect(const Position& pos, uint8_t effect) {
 }
 
 void Game::addMagicEffect(const SpectatorVec& spectators, const Position& pos, uint8_t effect) {
-	for (Creature* spectator : spectators) {
-		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+	NetworkMessage msg;
+	ProtocolGame::AddMagicEffect(msg, pos, effect);
+	sendToSpectators(spectators, msg, [&](const Player* player) { return player->canSee(pos); });
+}
+
+void Game::addCombatMagicEffect(const Position& pos, uint8_t effect) {
+	if (!bufferMagicEffect(pos, effect)) {
+		addMagicEffect(pos, effect);
+	}
+}
+
+void Game::addCombatMagicEffect(const SpectatorVec& spectators, const Position& pos, uint8_t effect) {
+	if (!bufferMagicEffect(pos, effect)) {
+		addMagicEffect(spectators, pos, effect);
+	}
+}
+
+void Game::beginCombatEvents(const Position& center, int32_t rangeX, int32_t rangeY) {
+	combatEventBuffers.push_back({center, rangeX, rangeY});
+}
+
+void Game::flushCombatEvents() {
+	if (combatEventBuffers.empty()) {
+		return;
+	}
+
+	CombatEventBuffer buffer = std::move(combatEventBuffers.back());
+	combatEventBuffers.pop_back();
+
+	// creatures are only released by Game::cleanup, so the pointers are still valid here
+	auto& healthUpdates = buffer.healthUpdates;
+	healthUpdates.erase(std::remove_if(healthUpdates.begin(), healthUpdates.end(), [&](const CombatEventBuffer::HealthUpdate& update) {
+		if (update.creature->isRemoved()) {
+			return true;
+		}
+
+		// moved away by a script while the cast was resolving
+		if (!buffer.contains(update.creature->getPosition())) {
+			addCreatureHealth(update.creature);
+			return true;
 		}
+		return false;
+	}), healthUpdates.end());
+
+	if (buffer.magicEffects.empty() && healthUpdates.empty()) {
+		return;
+	}
+
+	const int32_t rangeX = buffer.rangeX + Map::maxViewportX;
+	const int32_t rangeY = buffer.rangeY + Map::maxViewportY;
+
+	SpectatorVec spectators;
+	map.getSpectators(spectators, buffer.center, true, true, rangeX, rangeX, rangeY, rangeY);
+
+	// each event is encoded once, every spectator still receives them in the same order
+	NetworkMessage msg;
+	for (const auto& magicEffect : buffer.magicEffects) {
+		msg.reset();
+		ProtocolGame::AddMagicEffect(msg, magicEffect.position, magicEffect.type);
+		sendToSpectators(spectators, msg, [&](const Player* player) { return player->canSee(magicEffect.position); });
 	}
+
+	for (const auto& update : healthUpdates) {
+		msg.reset();
+		ProtocolGame::AddCreatureHealth(msg, update.creature);
+		sendToSpectators(spectators, msg, [&](const Player* player) {
+			if (!player->canSee(update.creature->getPosition())) {
+				return false;
+			}
+			combatMessagesSaved += update.count - 1;
+			return true;
+		});
+	}
+}
+
+bool Game::bufferMagicEffect(const Position& pos, uint8_t effect) {
+	if (combatEventBuffers.empty()) {
+		return false;
+	}
+
+	CombatEventBuffer& buffer = combatEventBuffers.back();
+	if (!buffer.contains(pos)) {
+		return false;
+	}
+
+	buffer.magicEffects.push_back({pos, effect});
+	return true;
+}
+
+bool Game::bufferCreatureHealth(const Creature* target) {
+	if (combatEventBuffers.empty()) {
+		return false;
+	}
+
+	CombatEventBuffer& buffer = combatEventBuffers.back();
+	if (!buffer.contains(target->getPosition())) {
+		return false;
+	}
+
+	for (auto& update : buffer.healthUpdates) {
+		if (update.creature == target) {
+			++update.count;
+			return true;
+		}
+	}
+
+	buffer.healthUpdates.push_back({target, 1});
+	return true;
 }
 
 void Game::addDistanceEffect(const Position& fromPos, const Position& toPos, uint8_t effect) {
@@ -4389,11 +4612,17 @@ void Game::addDistanceEffect(const Position& fromPos, const Position& toPos, uin
 }
 
 void Game::addDistanceEffect(const SpectatorVec& spectators, const Position& fromPos, const Position& toPos, uint8_t effect) {
-	for (Creature* spectator : spectators) {
-		if (Player* tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
-		}
-	}
+	NetworkMessage msg;
+	ProtocolGame::AddDistanceShoot(msg, fromPos, toPos, effect);
+	sendToSpectators(spectators, msg, [](const Player*) { return true; });
+}
+
+void Game::addLoginTimes(int64_t authenticateTime, int64_t loadTime, int64_t placeTime) {
+	++loginStats.logins;
+	loginStats.authenticateTime += authenticateTime;
+	loginStats.loadTime += loadTime;
+	loginStats.placeTime += placeTime;
+	loginStats.maxTime = std::max(loginStats.maxTime, authenticateTime + loadTime + placeTime);
 }
 
 void Game::setAccountStorageValue(const uint32_t accountId, const uint32_t key, const int32_t value) {
@@ -5595,6 +5824,7 @@ void Game::removeBedSleeper(uint32_t guid) {
 }
 
 Item* Game::getUniqueItem(uint16_t uniqueId) {
+	std::lock_guard<std::mutex> lockGuard(uniqueItemsLock);
 	auto it = uniqueItems.find(uniqueId);
 	if (it == uniqueItems.end()) {
 		return nullptr;
@@ -5603,6 +5833,7 @@ Item* Game::getUniqueItem(uint16_t uniqueId) {
 }
 
 bool Game::addUniqueItem(uint16_t uniqueId, Item* item) {
+	std::lock_guard<std::mutex> lockGuard(uniqueItemsLock);
 	auto result = uniqueItems.emplace(uniqueId, item);
 	if (!result.second) {
 		std::cout << "Duplicate unique id: " << uniqueId << std::endl;
@@ -5611,6 +5842,7 @@ bool Game::addUniqueItem(uint16_t uniqueId, Item* item) {
 }
 
 void Game::removeUniqueItem(uint16_t uniqueId) {
+	std::lock_guard<std::mutex> lockGuard(uniqueItemsLock);
 	auto it = uniqueItems.find(uniqueId);
 	if (it != uniqueItems.end()) {
 		uniqueItems.erase(it);
@@ -5705,6 +5937,8 @@ bool Game::reload(ReloadTypes_t reloadType) {
 			g_weapons->loadDefaults();
 			quests.reload();
 			mounts.reload();
+			customAttributes.reload();
+			customSkills.reload();
 			g_globalEvents->reload();
 			events::reload();
 			g_chat->load();
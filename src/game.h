@@ -4,8 +4,11 @@
 #ifndef FS_GAME_H
 #define FS_GAME_H
 
+#include "customattributes.h"
+#include "customskills.h"
 #include "groups.h"
 #include "map.h"
+#include "mapchunks.h"
 #include "mounts.h"
 #include "player.h"
 #include "position.h"
@@ -62,6 +65,41 @@ static constexpr int32_t RANGE_REQUEST_TRADE_INTERVAL = 400;
 static constexpr uint8_t ITEM_STACK_SIZE = 100;
 static constexpr int32_t MAX_STACKPOS = 10;
 
+// magic effects and health updates collected while an area cast resolves, sent to
+// each spectator once the cast has hit all of its targets
+struct CombatEventBuffer {
+	struct MagicEffect {
+		Position position;
+		uint8_t type;
+	};
+
+	struct HealthUpdate {
+		const Creature* creature;
+		uint16_t count;
+	};
+
+	bool contains(const Position& pos) const {
+		return pos.z == center.z && pos.getDistanceX(center) <= rangeX && pos.getDistanceY(center) <= rangeY;
+	}
+
+	Position center;
+	int32_t rangeX;
+	int32_t rangeY;
+
+	std::vector<MagicEffect> magicEffects = {};
+	std::vector<HealthUpdate> healthUpdates = {};
+};
+
+// time in milliseconds the logins spent in each stage, the authentication and
+// load stages run on the database thread, the place stage on the dispatcher
+struct LoginStats {
+	uint64_t logins = 0;
+	int64_t authenticateTime = 0;
+	int64_t loadTime = 0;
+	int64_t placeTime = 0;
+	int64_t maxTime = 0;
+};
+
 /**
  * Main Game class.
  * This class is responsible to control everything that happens
@@ -453,6 +491,20 @@ class Game {
 		void addDistanceEffect(const Position& fromPos, const Position& toPos, uint8_t effect);
 		static void addDistanceEffect(const SpectatorVec& spectators, const Position& fromPos, const Position& toPos, uint8_t effect);
 
+		// encodes skipped because a broadcast packet was copied to its spectators
+		static uint64_t broadcastEncodesSaved;
+		uint64_t getBroadcastEncodesSaved() const { return broadcastEncodesSaved; }
+
+		// while a combat event buffer is open, the hit effects and health updates of
+		// the combat inside its range are queued and sent once per spectator by flushCombatEvents
+		void beginCombatEvents(const Position& center, int32_t rangeX, int32_t rangeY);
+		void flushCombatEvents();
+		void addCombatMagicEffect(const Position& pos, uint8_t effect);
+		uint64_t getCombatMessagesSaved() const { return combatMessagesSaved; }
+
+		void addLoginTimes(int64_t authenticateTime, int64_t loadTime, int64_t placeTime);
+		const LoginStats& getLoginStats() const { return loginStats; }
+
 		void setAccountStorageValue(const uint32_t accountId, const uint32_t key, const int32_t value);
 		int32_t getAccountStorageValue(const uint32_t accountId, const uint32_t key) const;
 		void loadAccountStorageValues();
@@ -503,8 +555,11 @@ class Game {
 
 		bool reload(ReloadTypes_t reloadType);
 
+		CustomAttributes customAttributes;
+		CustomSkills customSkills;
 		Groups groups;
 		Map map;
+		MapChunks mapChunks;
 		Mounts mounts;
 		Quests quests;
 
@@ -534,11 +589,18 @@ class Game {
 		void checkDecay();
 		void internalDecayItem(Item* item);
 
+		bool bufferMagicEffect(const Position& pos, uint8_t effect);
+		bool bufferCreatureHealth(const Creature* target);
+		void addCombatMagicEffect(const SpectatorVec& spectators, const Position& pos, uint8_t effect);
+		void reflectDamage(uint32_t attackerId, Creature* target, const CombatDamage& damage, int32_t realDamage);
+
 		std::unordered_map<uint32_t, Player*> players;
 		std::unordered_map<std::string, Player*> mappedPlayerNames;
 		std::unordered_map<uint32_t, Player*> mappedPlayerGuids;
 		std::unordered_map<uint32_t, Guild_ptr> guilds;
 		std::unordered_map<uint16_t, Item*> uniqueItems;
+		// player items are deserialized on the database thread during login
+		std::mutex uniqueItemsLock;
 		std::unordered_map<uint32_t, std::unordered_map<uint32_t, int32_t>> accountStorageMap;
 
 		std::list<Item*> decayItems[EVENT_DECAY_BUCKETS];
@@ -561,6 +623,11 @@ class Game {
 
 		std::unordered_set<Tile*> tilesToClean;
 
+		std::vector<CombatEventBuffer> combatEventBuffers;
+		uint64_t combatMessagesSaved = 0;
+
+		LoginStats loginStats;
+
 		ModalWindow offlineTrainingWindow { std::numeric_limits<uint32_t>::max(), "Choose a Skill", "Please choose a skill:" };
 
 		static constexpr uint8_t LIGHT_DAY = 250;
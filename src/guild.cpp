@@ -60,8 +60,7 @@ GuildRank_ptr Guild::getRankByLevel(uint8_t level) const {
 	return nullptr;
 }
 
-Guild_ptr IOGuild::loadGuild(uint32_t guildId) {
-	Database& db = Database::getInstance();
+Guild_ptr IOGuild::loadGuild(Database& db, uint32_t guildId) {
 	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `name` FROM `guilds` WHERE `id` = {:d}", guildId));
 	if (!result) {
 		return nullptr;
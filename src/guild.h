@@ -4,6 +4,7 @@
 #ifndef FS_GUILD_H
 #define FS_GUILD_H
 
+class Database;
 class Player;
 
 using GuildWarVector = std::vector<uint32_t>;
@@ -71,7 +72,7 @@ class Guild {
 using Guild_ptr = std::shared_ptr<Guild>;
 
 namespace IOGuild {
-	Guild_ptr loadGuild(uint32_t guildId);
+	Guild_ptr loadGuild(Database& db, uint32_t guildId);
 	uint32_t getGuildIdByName(const std::string& name);
 };
 
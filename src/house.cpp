@@ -17,6 +17,19 @@ extern Game g_game;
 
 House::House(uint32_t houseId) : id(houseId) {}
 
+void House::onItemChanged(const Item* item) {
+	const Cylinder* topParent = item->getTopParent();
+	if (!topParent || topParent->getCreature()) {
+		return;
+	}
+
+	if (const Tile* tile = item->getTile()) {
+		if (House* house = tile->getHouse()) {
+			house->setItemsChanged();
+		}
+	}
+}
+
 void House::addTile(HouseTile* tile) {
 	tile->setFlag(TILESTATE_PROTECTIONZONE);
 	houseTiles.push_back(tile);
@@ -427,7 +440,7 @@ namespace {
 			return guild;
 		}
 
-		return IOGuild::loadGuild(guildId);
+		return IOGuild::loadGuild(Database::getInstance(), guildId);
 	}
 
 }
@@ -591,7 +604,11 @@ void Houses::payHouses(RentPeriod_t rentPeriod) const {
 		return;
 	}
 
+	const auto startTime = std::chrono::steady_clock::now();
 	time_t currentTime = time(nullptr);
+
+	std::vector<House*> dueHouses;
+	std::vector<uint32_t> ownerIds;
 	for (const auto& it : houseMap) {
 		House* house = it.second;
 		if (house->getOwner() == 0) {
@@ -603,78 +620,107 @@ void Houses::payHouses(RentPeriod_t rentPeriod) const {
 			continue;
 		}
 
-		const uint32_t ownerId = house->getOwner();
-		Town* town = g_game.map.towns.getTown(house->getTownId());
-		if (!town) {
+		if (!g_game.map.towns.getTown(house->getTownId())) {
 			continue;
 		}
 
-		Player player(nullptr);
-		if (!IOLoginData::loadPlayerById(&player, ownerId)) {
+		dueHouses.push_back(house);
+		ownerIds.push_back(house->getOwner());
+	}
+
+	if (dueHouses.empty()) {
+		return;
+	}
+
+	// owners are not loaded, only their balances and inboxes are touched and
+	// houses are evicted once everything else has been written
+	std::map<uint32_t, uint64_t> balances = IOLoginData::getBankBalances(ownerIds);
+	std::map<uint32_t, uint64_t> payments;
+	std::vector<std::pair<uint32_t, const Item*>> letters;
+	std::vector<House*> evictions;
+
+	time_t paidUntil = currentTime;
+	std::string period;
+	switch (rentPeriod) {
+		case RENTPERIOD_DAILY:
+			paidUntil += 24 * 60 * 60;
+			period = "daily";
+			break;
+		case RENTPERIOD_WEEKLY:
+			paidUntil += 24 * 60 * 60 * 7;
+			period = "weekly";
+			break;
+		case RENTPERIOD_MONTHLY:
+			paidUntil += 24 * 60 * 60 * 30;
+			period = "monthly";
+			break;
+		case RENTPERIOD_YEARLY:
+			paidUntil += 24 * 60 * 60 * 365;
+			period = "annual";
+			break;
+		default:
+			break;
+	}
+
+	std::vector<House*> paidHouses;
+	std::vector<House*> warnedHouses;
+	for (House* house : dueHouses) {
+		const uint32_t ownerId = house->getOwner();
+		auto balance = balances.find(ownerId);
+		if (balance == balances.end()) {
 			// Player doesn't exist, reset house owner
 			house->setOwner(0);
 			continue;
 		}
 
-		if (player.getBankBalance() >= rent) {
-			player.setBankBalance(player.getBankBalance() - rent);
-
-			time_t paidUntil = currentTime;
-			switch (rentPeriod) {
-				case RENTPERIOD_DAILY:
-					paidUntil += 24 * 60 * 60;
-					break;
-				case RENTPERIOD_WEEKLY:
-					paidUntil += 24 * 60 * 60 * 7;
-					break;
-				case RENTPERIOD_MONTHLY:
-					paidUntil += 24 * 60 * 60 * 30;
-					break;
-				case RENTPERIOD_YEARLY:
-					paidUntil += 24 * 60 * 60 * 365;
-					break;
-				default:
-					break;
-			}
-
-			house->setPaidUntil(paidUntil);
-			house->setPayRentWarnings(0);
+		const uint32_t rent = house->getRent();
+		if (balance->second >= rent) {
+			balance->second -= rent;
+			payments[ownerId] += rent;
+			paidHouses.push_back(house);
+		} else if (house->getPayRentWarnings() < 7) {
+			int32_t daysLeft = 7 - house->getPayRentWarnings();
+
+			Item* letter = Item::CreateItem(ITEM_LETTER_STAMPED);
+			letter->setText(fmt::format("Warning! \nThe {:s} rent of {:d} gold for your house \"{:s}\" is payable. Have it within {:d} days or you will lose this house.", period, house->getRent(), house->getName(), daysLeft));
+			letters.emplace_back(ownerId, letter);
+			warnedHouses.push_back(house);
 		} else {
-			if (house->getPayRentWarnings() < 7) {
-				int32_t daysLeft = 7 - house->getPayRentWarnings();
-
-				Item* letter = Item::CreateItem(ITEM_LETTER_STAMPED);
-				std::string period;
-
-				switch (rentPeriod) {
-					case RENTPERIOD_DAILY:
-						period = "daily";
-						break;
-
-					case RENTPERIOD_WEEKLY:
-						period = "weekly";
-						break;
+			evictions.push_back(house);
+		}
+	}
 
-					case RENTPERIOD_MONTHLY:
-						period = "monthly";
-						break;
+	// houses are only marked as paid or warned once the owners have been charged and notified
+	bool written;
+	{
+		DBTransaction transaction;
+		written = transaction.begin() && IOLoginData::decreaseBankBalances(payments) && IOLoginData::addInboxItems(letters) && transaction.commit();
+	}
 
-					case RENTPERIOD_YEARLY:
-						period = "annual";
-						break;
+	for (const auto& it : letters) {
+		delete it.second;
+	}
 
-					default:
-						break;
-				}
+	if (written) {
+		for (House* house : paidHouses) {
+			house->setPaidUntil(paidUntil);
+			house->setPayRentWarnings(0);
+		}
 
-				letter->setText(fmt::format("Warning! \nThe {:s} rent of {:d} gold for your house \"{:s}\" is payable. Have it within {:d} days or you will lose this house.", period, house->getRent(), house->getName(), daysLeft));
-				g_game.internalAddItem(player.getInbox().get(), letter, INDEX_WHEREEVER, FLAG_NOLIMIT);
-				house->setPayRentWarnings(house->getPayRentWarnings() + 1);
-			} else {
-				house->setOwner(0, true, &player);
-			}
+		for (House* house : warnedHouses) {
+			house->setPayRentWarnings(house->getPayRentWarnings() + 1);
 		}
+	} else {
+		std::cout << "[Error - Houses::payHouses] Failed to charge " << payments.size() << " owners and send " << letters.size() << " warnings, rent will be collected again on the next run" << std::endl;
+		paidHouses.clear();
+		warnedHouses.clear();
+	}
 
-		IOLoginData::savePlayer(&player);
+	// losing a house moves its items to the owner's depot, which needs the full player
+	for (House* house : evictions) {
+		house->setOwner(0, true);
 	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+	std::cout << ">> Paid rent for " << paidHouses.size() << " of " << dueHouses.size() << " houses, " << warnedHouses.size() << " warnings sent and " << evictions.size() << " houses lost (" << elapsed.count() << " ms)" << std::endl;
 }
\ No newline at end of file
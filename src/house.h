@@ -194,6 +194,25 @@ class House {
 			return houseTiles;
 		}
 
+		// bumped on every item change on the house tiles, saves skip houses
+		// whose items did not change since they were last written
+		void setItemsChanged() {
+			++itemsVersion;
+		}
+		uint32_t getItemsVersion() const {
+			return itemsVersion;
+		}
+		bool hasUnsavedItems() const {
+			return itemsVersion != savedItemsVersion;
+		}
+		void setItemsSaved(uint32_t version) {
+			savedItemsVersion = version;
+		}
+
+		// for item changes that do not go through the tile or container functions,
+		// items carried by a creature standing in the house are not house items
+		static void onItemChanged(const Item* item);
+
 		const std::set<Door*>& getDoors() const {
 			return doorSet;
 		}
@@ -232,6 +251,8 @@ class House {
 		uint32_t rentWarnings = 0;
 		uint32_t rent = 0;
 		uint32_t townId = 0;
+		uint32_t itemsVersion = 0;
+		uint32_t savedItemsVersion = 0;
 
 		Position posEntry = {};
 
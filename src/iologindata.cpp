@@ -15,6 +15,22 @@
 
 extern Game g_game;
 
+namespace {
+
+template<typename Range, typename Projection>
+std::string joinIds(const Range& range, Projection projection) {
+	std::string ids;
+	for (const auto& value : range) {
+		if (!ids.empty()) {
+			ids.push_back(',');
+		}
+		ids += std::to_string(projection(value));
+	}
+	return ids;
+}
+
+}
+
 std::string decodeSecret(std::string_view secret) {
 	// simple base32 decoding
 	std::string key;
@@ -43,9 +59,7 @@ std::string decodeSecret(std::string_view secret) {
 	return key;
 }
 
-std::pair<uint32_t, std::string> IOLoginData::gameworldAuthentication(std::string_view accountName, std::string_view password, std::string_view characterName, std::string_view token, uint32_t tokenTime) {
-	Database& db = Database::getInstance();
-
+std::pair<uint32_t, std::string> IOLoginData::gameworldAuthentication(Database& db, std::string_view accountName, std::string_view password, std::string_view characterName, std::string_view token, uint32_t tokenTime) {
 	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `id`, UNHEX(`password`) AS `password`, `secret` FROM `accounts` WHERE `name` = {:s}", db.escapeString(accountName)));
 	if (!result) {
 		return std::make_pair(0, std::string{characterName});
@@ -121,30 +135,47 @@ void IOLoginData::updateOnlineStatus(uint32_t guid, bool login) {
 	}
 }
 
-bool IOLoginData::preloadPlayer(Player* player, const std::string& name) {
-	Database& db = Database::getInstance();
-
-	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `p`.`id`, `p`.`account_id`, `p`.`group_id`, `a`.`type`, `a`.`premium_ends_at` FROM `players` as `p` JOIN `accounts` as `a` ON `a`.`id` = `p`.`account_id` WHERE `p`.`name` = {:s} AND `p`.`deletion` = 0", db.escapeString(name)));
+bool IOLoginData::preloadPlayer(Database& db, const std::string& name, PlayerPreload& preload) {
+	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `p`.`id`, `p`.`account_id`, `p`.`group_id`, `a`.`type`, `a`.`premium_ends_at`, `g`.`guild_id` FROM `players` as `p` JOIN `accounts` as `a` ON `a`.`id` = `p`.`account_id` LEFT JOIN `guild_membership` as `g` ON `g`.`player_id` = `p`.`id` WHERE `p`.`name` = {:s} AND `p`.`deletion` = 0", db.escapeString(name)));
 	if (!result) {
 		return false;
 	}
 
-	player->setGUID(result->getNumber<uint32_t>("id"));
-	Group* group = g_game.groups.getGroup(result->getNumber<uint16_t>("group_id"));
+	preload.guid = result->getNumber<uint32_t>("id");
+	preload.accountId = result->getNumber<uint32_t>("account_id");
+	preload.groupId = result->getNumber<uint16_t>("group_id");
+	preload.guildId = result->getNumber<uint32_t>("guild_id");
+	preload.accountType = static_cast<AccountType_t>(result->getNumber<uint16_t>("type"));
+	preload.premiumEndsAt = result->getNumber<time_t>("premium_ends_at");
+	return true;
+}
+
+bool IOLoginData::applyPreload(Player* player, const PlayerPreload& preload) {
+	Group* group = g_game.groups.getGroup(preload.groupId);
 	if (!group) {
-		std::cout << "[Error - IOLoginData::preloadPlayer] " << player->name << " has Group ID " << result->getNumber<uint16_t>("group_id") << " which doesn't exist." << std::endl;
+		std::cout << "[Error - IOLoginData::applyPreload] " << player->name << " has Group ID " << preload.groupId << " which doesn't exist." << std::endl;
 		return false;
 	}
+
+	player->setGUID(preload.guid);
 	player->setGroup(group);
-	player->accountNumber = result->getNumber<uint32_t>("account_id");
-	player->accountType = static_cast<AccountType_t>(result->getNumber<uint16_t>("type"));
-	player->premiumEndsAt = result->getNumber<time_t>("premium_ends_at");
+	player->accountNumber = preload.accountId;
+	player->accountType = preload.accountType;
+	player->premiumEndsAt = preload.premiumEndsAt;
 	return true;
 }
 
 bool IOLoginData::loadPlayerById(Player* player, uint32_t id) {
-	Database& db = Database::getInstance();
-	return loadPlayer(player, db.storeQuery(fmt::format("SELECT `id`, `name`, `account_id`, `group_id`, `sex`, `vocation`, `experience`, `level`, `maglevel`, `health`, `healthmax`, `blessings`, `mana`, `manamax`, `manaspent`, `soul`, `lookbody`, `lookfeet`, `lookhead`, `looklegs`, `looktype`, `lookaddons`, `currentmount`, `posx`, `posy`, `posz`, `cap`, `lastlogin`, `lastlogout`, `lastip`, `conditions`, `skulltime`, `skull`, `town_id`, `balance`, `offlinetraining_time`, `offlinetraining_skill`, `stamina`, `skill_fist`, `skill_fist_tries`, `skill_club`, `skill_club_tries`, `skill_sword`, `skill_sword_tries`, `skill_axe`, `skill_axe_tries`, `skill_dist`, `skill_dist_tries`, `skill_shielding`, `skill_shielding_tries`, `skill_fishing`, `skill_fishing_tries`, `direction` FROM `players` WHERE `id` = {:d}", id)));
+	PlayerBindings bindings;
+	if (!loadPlayerById(Database::getInstance(), player, id, bindings)) {
+		return false;
+	}
+
+	return bindPlayer(player, bindings);
+}
+
+bool IOLoginData::loadPlayerById(Database& db, Player* player, uint32_t id, PlayerBindings& bindings) {
+	return loadPlayer(db, player, db.storeQuery(fmt::format("SELECT `id`, `name`, `account_id`, `group_id`, `sex`, `vocation`, `experience`, `level`, `maglevel`, `health`, `healthmax`, `blessings`, `mana`, `manamax`, `manaspent`, `soul`, `lookbody`, `lookfeet`, `lookhead`, `looklegs`, `looktype`, `lookaddons`, `currentmount`, `posx`, `posy`, `posz`, `cap`, `lastlogin`, `lastlogout`, `lastip`, `conditions`, `skulltime`, `skull`, `town_id`, `balance`, `offlinetraining_time`, `offlinetraining_skill`, `stamina`, `skill_fist`, `skill_fist_tries`, `skill_club`, `skill_club_tries`, `skill_sword`, `skill_sword_tries`, `skill_axe`, `skill_axe_tries`, `skill_dist`, `skill_dist_tries`, `skill_shielding`, `skill_shielding_tries`, `skill_fishing`, `skill_fishing_tries`, `direction` FROM `players` WHERE `id` = {:d}", id)), bindings);
 }
 
 bool IOLoginData::loadPlayerByName(Player* player, const std::string& name) {
@@ -152,8 +183,8 @@ bool IOLoginData::loadPlayerByName(Player* player, const std::string& name) {
 	return loadPlayer(player, db.storeQuery(fmt::format("SELECT `id`, `name`, `account_id`, `group_id`, `sex`, `vocation`, `experience`, `level`, `maglevel`, `health`, `healthmax`, `blessings`, `mana`, `manamax`, `manaspent`, `soul`, `lookbody`, `lookfeet`, `lookhead`, `looklegs`, `looktype`, `lookaddons`, `currentmount`, `posx`, `posy`, `posz`, `cap`, `lastlogin`, `lastlogout`, `lastip`, `conditions`, `skulltime`, `skull`, `town_id`, `balance`, `offlinetraining_time`, `offlinetraining_skill`, `stamina`, `skill_fist`, `skill_fist_tries`, `skill_club`, `skill_club_tries`, `skill_sword`, `skill_sword_tries`, `skill_axe`, `skill_axe_tries`, `skill_dist`, `skill_dist_tries`, `skill_shielding`, `skill_shielding_tries`, `skill_fishing`, `skill_fishing_tries`, `direction` FROM `players` WHERE `name` = {:s}", db.escapeString(name))));
 }
 
-static GuildWarVector getWarList(uint32_t guildId) {
-	DBResult_ptr result = Database::getInstance().storeQuery(fmt::format("SELECT `guild1`, `guild2` FROM `guild_wars` WHERE (`guild1` = {:d} OR `guild2` = {:d}) AND `ended` = 0 AND `status` = 1", guildId, guildId));
+static GuildWarVector getWarList(Database& db, uint32_t guildId) {
+	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `guild1`, `guild2` FROM `guild_wars` WHERE (`guild1` = {:d} OR `guild2` = {:d}) AND `ended` = 0 AND `status` = 1", guildId, guildId));
 	if (!result) {
 		return {};
 	}
@@ -172,11 +203,18 @@ static GuildWarVector getWarList(uint32_t guildId) {
 }
 
 bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
-	if (!result) {
+	PlayerBindings bindings;
+	if (!loadPlayer(Database::getInstance(), player, std::move(result), bindings)) {
 		return false;
 	}
 
-	Database& db = Database::getInstance();
+	return bindPlayer(player, bindings);
+}
+
+bool IOLoginData::loadPlayer(Database& db, Player* player, DBResult_ptr result, PlayerBindings& bindings) {
+	if (!result) {
+		return false;
+	}
 
 	uint32_t accountId = result->getNumber<uint32_t>("account_id");
 
@@ -193,12 +231,10 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 	player->accountType = static_cast<AccountType_t>(account->getNumber<int32_t>("type"));
 	player->premiumEndsAt = account->getNumber<time_t>("premium_ends_at");
 
-	Group* group = g_game.groups.getGroup(result->getNumber<uint16_t>("group_id"));
-	if (!group) {
-		std::cout << "[Error - IOLoginData::loadPlayer] " << player->name << " has Group ID " << result->getNumber<uint16_t>("group_id") << " which doesn't exist" << std::endl;
-		return false;
-	}
-	player->setGroup(group);
+	// groups, vocations, towns and mounts can be reloaded by the dispatcher, bindPlayer resolves them
+	bindings.groupId = result->getNumber<uint16_t>("group_id");
+	bindings.vocationId = result->getNumber<uint16_t>("vocation");
+	bindings.townId = result->getNumber<uint32_t>("town_id");
 
 	player->bankBalance = result->getNumber<uint64_t>("balance");
 
@@ -239,23 +275,10 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 		condition = Condition::createCondition(propStream);
 	}
 
-	if (!player->setVocation(result->getNumber<uint16_t>("vocation"))) {
-		std::cout << "[Error - IOLoginData::loadPlayer] " << player->name << " has Vocation ID " << result->getNumber<uint16_t>("vocation") << " which doesn't exist" << std::endl;
-		return false;
-	}
-
 	player->mana = result->getNumber<uint32_t>("mana");
 	player->manaMax = result->getNumber<uint32_t>("manamax");
 	player->magLevel = result->getNumber<uint32_t>("maglevel");
-
-	uint64_t nextManaCount = player->vocation->getReqMana(player->magLevel + 1);
-	uint64_t manaSpent = result->getNumber<uint64_t>("manaspent");
-	if (manaSpent > nextManaCount) {
-		manaSpent = 0;
-	}
-
-	player->manaSpent = manaSpent;
-	player->magLevelPercent = Player::getPercentLevel(player->manaSpent, nextManaCount);
+	player->manaSpent = result->getNumber<uint64_t>("manaspent");
 
 	player->health = result->getNumber<int32_t>("health");
 	player->healthMax = result->getNumber<int32_t>("healthmax");
@@ -270,20 +293,9 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 	player->currentMount = result->getNumber<uint16_t>("currentmount");
 	player->direction = static_cast<Direction> (result->getNumber<uint16_t>("direction"));
 
-	if (g_game.getWorldType() != WORLD_TYPE_PVP_ENFORCED) {
-		const time_t skullSeconds = result->getNumber<time_t>("skulltime") - time(nullptr);
-		if (skullSeconds > 0) {
-			//ensure that we round up the number of ticks
-			player->skullTicks = (skullSeconds + 2);
-
-			uint16_t skull = result->getNumber<uint16_t>("skull");
-			if (skull == SKULL_RED) {
-				player->skull = SKULL_RED;
-			} else if (skull == SKULL_BLACK) {
-				player->skull = SKULL_BLACK;
-			}
-		}
-	}
+	// skulls depend on the world type, which is applied by bindPlayer
+	bindings.skullTime = result->getNumber<time_t>("skulltime");
+	bindings.skull = result->getNumber<uint16_t>("skull");
 
 	player->loginPosition.x = result->getNumber<uint16_t>("posx");
 	player->loginPosition.y = result->getNumber<uint16_t>("posy");
@@ -295,72 +307,41 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 	player->offlineTrainingTime = result->getNumber<int32_t>("offlinetraining_time") * 1000;
 	player->offlineTrainingSkill = result->getNumber<int32_t>("offlinetraining_skill");
 
-	Town* town = g_game.map.towns.getTown(result->getNumber<uint32_t>("town_id"));
-	if (!town) {
-		std::cout << "[Error - IOLoginData::loadPlayer] " << player->name << " has Town ID " << result->getNumber<uint32_t>("town_id") << " which doesn't exist" << std::endl;
-		return false;
-	}
-
-	player->town = town;
-
-	const Position& loginPos = player->loginPosition;
-	if (loginPos.x == 0 && loginPos.y == 0 && loginPos.z == 0) {
-		player->loginPosition = player->getTemplePosition();
-	}
-
 	player->staminaMinutes = result->getNumber<uint16_t>("stamina");
 
 	static const std::string skillNames[] = {"skill_fist", "skill_club", "skill_sword", "skill_axe", "skill_dist", "skill_shielding", "skill_fishing"};
 	static const std::string skillNameTries[] = {"skill_fist_tries", "skill_club_tries", "skill_sword_tries", "skill_axe_tries", "skill_dist_tries", "skill_shielding_tries", "skill_fishing_tries"};
 	static constexpr size_t size = sizeof(skillNames) / sizeof(std::string);
 	for (uint8_t i = 0; i < size; ++i) {
-		uint16_t skillLevel = result->getNumber<uint16_t>(skillNames[i]);
-		uint64_t skillTries = result->getNumber<uint64_t>(skillNameTries[i]);
-		uint64_t nextSkillTries = player->vocation->getReqSkillTries(i, skillLevel + 1);
-		if (skillTries > nextSkillTries) {
-			skillTries = 0;
-		}
-
-		player->skills[i].level = skillLevel;
-		player->skills[i].tries = skillTries;
-		player->skills[i].percent = Player::getPercentLevel(skillTries, nextSkillTries);
+		player->skills[i].level = result->getNumber<uint16_t>(skillNames[i]);
+		player->skills[i].tries = result->getNumber<uint64_t>(skillNameTries[i]);
 	}
 
+	// the guild is looked up in the game cache by bindPlayer
 	if ((result = db.storeQuery(fmt::format("SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = {:d}", player->getGUID())))) {
 		uint32_t guildId = result->getNumber<uint32_t>("guild_id");
-		uint32_t playerRankId = result->getNumber<uint32_t>("rank_id");
+		bindings.guildRankId = result->getNumber<uint32_t>("rank_id");
 		player->guildNick = result->getString("nick");
 
-		auto guild = g_game.getGuild(guildId);
-		if (!guild) {
-			guild = IOGuild::loadGuild(guildId);
-			if (guild) {
-				g_game.addGuild(guild);
-			} else {
-				std::cout << "[Warning - IOLoginData::loadPlayer] " << player->name << " has Guild ID " << guildId << " which doesn't exist" << std::endl;
+		// a cached guild is only read by the dispatcher, so just its rank is fetched
+		const bool guildCached = guildId == bindings.cachedGuildId;
+		if (guildCached) {
+			if ((result = db.storeQuery(fmt::format("SELECT `name`, `level` FROM `guild_ranks` WHERE `id` = {:d} AND `guild_id` = {:d}", bindings.guildRankId, guildId)))) {
+				bindings.guildRank = std::make_shared<GuildRank>(bindings.guildRankId, result->getString("name"), result->getNumber<uint16_t>("level"));
 			}
+		} else if ((bindings.guild = IOGuild::loadGuild(db, guildId))) {
+			bindings.guildRank = bindings.guild->getRankById(bindings.guildRankId);
 		}
 
-		if (guild) {
-			player->guild = guild;
-			auto rank = guild->getRankById(playerRankId);
-			if (!rank) {
-				if ((result = db.storeQuery(fmt::format("SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = {:d}", playerRankId)))) {
-					guild->addRank(result->getNumber<uint32_t>("id"), result->getString("name"), result->getNumber<uint16_t>("level"));
-				}
-
-				rank = guild->getRankById(playerRankId);
-				if (!rank) {
-					player->guild = nullptr;
-				}
-			}
-
-			player->guildRank = rank;
-			player->guildWarVector = getWarList(guildId);
+		if (guildCached || bindings.guild) {
+			bindings.guildId = guildId;
+			player->guildWarVector = getWarList(db, guildId);
 
 			if ((result = db.storeQuery(fmt::format("SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = {:d}", guildId)))) {
-				guild->setMemberCount(result->getNumber<uint32_t>("members"));
+				bindings.guildMemberCount = result->getNumber<uint32_t>("members");
 			}
+		} else {
+			std::cout << "[Warning - IOLoginData::loadPlayer] " << player->name << " has Guild ID " << guildId << " which doesn't exist" << std::endl;
 		}
 	}
 
@@ -482,17 +463,27 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 		}
 	}
 
-	//load storage map
+	//load storage map, the values are set by bindPlayer as they trigger scripts
 	if ((result = db.storeQuery(fmt::format("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = {:d}", player->getGUID())))) {
 		do {
-			player->setStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
+			bindings.storageValues.emplace_back(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"));
+		} while (result->next());
+	}
+
+	//load custom skills
+	if ((result = db.storeQuery(fmt::format("SELECT `skill_id`, `value` FROM `player_custom_skills` WHERE `player_id` = {:d}", player->getGUID())))) {
+		do {
+			const uint16_t skillId = result->getNumber<uint16_t>("skill_id");
+			if (skillId <= CUSTOMSKILL_LAST) {
+				player->customSkills[skillId] = result->getNumber<int32_t>("value");
+			}
 		} while (result->next());
 	}
 
-	//load vip list
+	//load vip list, the entries are added by bindPlayer once the group is known
 	if ((result = db.storeQuery(fmt::format("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {:d}", player->getAccount())))) {
 		do {
-			player->addVIPInternal(result->getNumber<uint32_t>("player_id"));
+			bindings.vipGuids.push_back(result->getNumber<uint32_t>("player_id"));
 		} while (result->next());
 	}
 
@@ -508,63 +499,155 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result) {
 	if ((result = db.storeQuery(
 	         fmt::format("SELECT `mount_id` FROM `player_mounts` WHERE `player_id` = {:d}", player->getGUID())))) {
 		do {
-			player->tameMount(result->getNumber<uint16_t>("mount_id"));
+			bindings.mountIds.push_back(result->getNumber<uint16_t>("mount_id"));
 		} while (result->next());
 	}
 
-	player->updateBaseSpeed();
-	player->updateInventoryWeight();
 	player->updateItemsLight(true);
 	return true;
 }
 
-bool IOLoginData::saveItems(const Player* player, const ItemBlockList& itemList, DBInsert& query_insert, PropWriteStream& propWriteStream) {
-	using ContainerBlock = std::pair<Container*, int32_t>;
-	std::vector<ContainerBlock> containers;
-	containers.reserve(32);
-
-	int32_t runningId = 100;
+bool IOLoginData::bindPlayer(Player* player, PlayerBindings& bindings) {
+	Group* group = g_game.groups.getGroup(bindings.groupId);
+	if (!group) {
+		std::cout << "[Error - IOLoginData::bindPlayer] " << player->name << " has Group ID " << bindings.groupId << " which doesn't exist" << std::endl;
+		return false;
+	}
+	player->setGroup(group);
 
-	Database& db = Database::getInstance();
-	for (const auto& it : itemList) {
-		int32_t pid = it.first;
-		Item* item = it.second;
-		++runningId;
+	if (!player->setVocation(bindings.vocationId)) {
+		std::cout << "[Error - IOLoginData::bindPlayer] " << player->name << " has Vocation ID " << bindings.vocationId << " which doesn't exist" << std::endl;
+		return false;
+	}
 
-		propWriteStream.clear();
-		item->serializeAttr(propWriteStream);
+	uint64_t nextManaCount = player->vocation->getReqMana(player->magLevel + 1);
+	if (player->manaSpent > nextManaCount) {
+		player->manaSpent = 0;
+	}
+	player->magLevelPercent = Player::getPercentLevel(player->manaSpent, nextManaCount);
 
-		if (!query_insert.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}, {:s}", player->getGUID(), pid, runningId, item->getID(), item->getSubType(), db.escapeString(propWriteStream.getStream())))) {
-			return false;
+	for (uint8_t i = SKILL_FIRST; i <= SKILL_LAST; ++i) {
+		Skill& skill = player->skills[i];
+		uint64_t nextSkillTries = player->vocation->getReqSkillTries(i, skill.level + 1);
+		if (skill.tries > nextSkillTries) {
+			skill.tries = 0;
 		}
+		skill.percent = Player::getPercentLevel(skill.tries, nextSkillTries);
+	}
 
-		if (Container* container = item->getContainer()) {
-			containers.emplace_back(container, runningId);
-		}
+	Town* town = g_game.map.towns.getTown(bindings.townId);
+	if (!town) {
+		std::cout << "[Error - IOLoginData::bindPlayer] " << player->name << " has Town ID " << bindings.townId << " which doesn't exist" << std::endl;
+		return false;
+	}
+	player->town = town;
+
+	const Position& loginPos = player->loginPosition;
+	if (loginPos.x == 0 && loginPos.y == 0 && loginPos.z == 0) {
+		player->loginPosition = player->getTemplePosition();
+	}
+
+	for (uint16_t mountId : bindings.mountIds) {
+		player->tameMount(mountId);
 	}
 
-	for (size_t i = 0; i < containers.size(); i++) {
-		const ContainerBlock& cb = containers[i];
-		Container* container = cb.first;
-		int32_t parentId = cb.second;
+	player->updateBaseSpeed();
+	player->updateInventoryWeight();
+
+	// the vip limit depends on the group
+	for (uint32_t vipGuid : bindings.vipGuids) {
+		player->addVIPInternal(vipGuid);
+	}
 
-		for (Item* item : container->getItemList()) {
-			++runningId;
+	if (g_game.getWorldType() != WORLD_TYPE_PVP_ENFORCED) {
+		const time_t skullSeconds = bindings.skullTime - time(nullptr);
+		if (skullSeconds > 0) {
+			//ensure that we round up the number of ticks
+			player->skullTicks = (skullSeconds + 2);
 
-			Container* subContainer = item->getContainer();
-			if (subContainer) {
-				containers.emplace_back(subContainer, runningId);
+			if (bindings.skull == SKULL_RED) {
+				player->skull = SKULL_RED;
+			} else if (bindings.skull == SKULL_BLACK) {
+				player->skull = SKULL_BLACK;
 			}
+		}
+	}
 
-			propWriteStream.clear();
-			item->serializeAttr(propWriteStream);
+	if (bindings.guildId != 0) {
+		auto guild = g_game.getGuild(bindings.guildId);
+		if (!guild) {
+			guild = bindings.guild;
+			if (!guild) {
+				// the cached guild was released while the player was loaded
+				guild = IOGuild::loadGuild(Database::getInstance(), bindings.guildId);
+			}
+			g_game.addGuild(guild);
+		}
 
-			if (!query_insert.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}, {:s}", player->getGUID(), parentId, runningId, item->getID(), item->getSubType(), db.escapeString(propWriteStream.getStream())))) {
-				return false;
+		GuildRank_ptr rank = nullptr;
+		if (guild) {
+			rank = guild->getRankById(bindings.guildRankId);
+			if (!rank) {
+				// the rank was created after the guild got cached
+				if (const auto& loadedRank = bindings.guildRank) {
+					guild->addRank(loadedRank->id, loadedRank->name, loadedRank->level);
+					rank = guild->getRankById(bindings.guildRankId);
+				}
 			}
 		}
+
+		if (rank) {
+			player->guild = guild;
+			player->guildRank = rank;
+			guild->setMemberCount(bindings.guildMemberCount);
+		} else {
+			player->guildWarVector.clear();
+		}
 	}
-	return query_insert.execute();
+
+	for (const auto& [key, value] : bindings.storageValues) {
+		player->setStorageValue(key, value, true);
+	}
+
+	player->updateEquipmentAttributes();
+	return true;
+}
+
+bool IOLoginData::saveItem(const Player* player, int32_t pid, const Item* item, int32_t& runningId, DBInsert& query_insert, PropWriteStream& propWriteStream) {
+	const auto addRow = [&](int32_t parentId, const Item* item) {
+		propWriteStream.clear();
+		item->serializeAttr(propWriteStream);
+
+		std::array<char, 96> values;
+		const auto result = fmt::format_to_n(values.data(), values.size(), "{:d}, {:d}, {:d}, {:d}, {:d}", player->getGUID(), parentId, ++runningId, item->getID(), item->getSubType());
+		return query_insert.addRow(std::string_view(values.data(), result.size), propWriteStream.getStream());
+	};
+
+	if (!addRow(pid, item)) {
+		return false;
+	}
+
+	const Container* container = item->getContainer();
+	if (!container) {
+		return true;
+	}
+
+	// sids of the containers on the path down to the current item, by depth
+	boost::container::small_vector<int32_t, 8> parentIds {runningId};
+	for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+		const size_t depth = it.getDepth();
+		parentIds.resize(depth + 1);
+
+		const Item* subItem = *it;
+		if (!addRow(parentIds[depth], subItem)) {
+			return false;
+		}
+
+		if (subItem->getContainer()) {
+			parentIds.push_back(runningId);
+		}
+	}
+	return true;
 }
 
 bool IOLoginData::savePlayer(Player* player) {
@@ -586,7 +669,7 @@ bool IOLoginData::savePlayer(Player* player) {
 	//serialize conditions
 	PropWriteStream propWriteStream;
 	for (Condition* condition : player->conditions) {
-		if (condition->isPersistent()) {
+		if (condition && condition->isPersistent()) {
 			condition->serialize(propWriteStream);
 			propWriteStream.write<uint8_t>(CONDITIONATTR_END);
 		}
@@ -710,15 +793,16 @@ bool IOLoginData::savePlayer(Player* player) {
 
 	DBInsert itemsQuery("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
 
-	ItemBlockList itemList;
+	// the rows are written straight into the insert, every table numbers its sids from 100
+	int32_t runningId = 100;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		Item* item = player->inventory[slotId];
-		if (item) {
-			itemList.emplace_back(slotId, item);
+		if (item && !saveItem(player, slotId, item, runningId, itemsQuery, propWriteStream)) {
+			return false;
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
+	if (!itemsQuery.execute()) {
 		return false;
 	}
 
@@ -729,15 +813,17 @@ bool IOLoginData::savePlayer(Player* player) {
 		}
 
 		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-		itemList.clear();
 
+		runningId = 100;
 		for (const auto& it : player->depotChests) {
 			for (Item* item : it.second->getItemList()) {
-				itemList.emplace_back(it.first, item);
+				if (!saveItem(player, it.first, item, runningId, depotQuery, propWriteStream)) {
+					return false;
+				}
 			}
 		}
 
-		if (!saveItems(player, itemList, depotQuery, propWriteStream)) {
+		if (!depotQuery.execute()) {
 			return false;
 		}
 	}
@@ -748,13 +834,15 @@ bool IOLoginData::savePlayer(Player* player) {
 	}
 
 	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-	itemList.clear();
 
+	runningId = 100;
 	for (Item* item : player->getInbox()->getItemList()) {
-		itemList.emplace_back(0, item);
+		if (!saveItem(player, 0, item, runningId, inboxQuery, propWriteStream)) {
+			return false;
+		}
 	}
 
-	if (!saveItems(player, itemList, inboxQuery, propWriteStream)) {
+	if (!inboxQuery.execute()) {
 		return false;
 	}
 
@@ -764,29 +852,50 @@ bool IOLoginData::savePlayer(Player* player) {
 	}
 
 	DBInsert storeInboxQuery("INSERT INTO `player_storeinboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-	itemList.clear();
 
+	runningId = 100;
 	for (Item* item : player->getStoreInbox()->getItemList()) {
-		itemList.emplace_back(0, item);
+		if (!saveItem(player, 0, item, runningId, storeInboxQuery, propWriteStream)) {
+			return false;
+		}
+	}
+
+	if (!storeInboxQuery.execute()) {
+		return false;
+	}
+
+	// only the storage keys changed since the last save are written
+	std::vector<uint32_t> removedStorageKeys;
+	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ", " ON DUPLICATE KEY UPDATE `value` = VALUES(`value`)");
+
+	for (uint32_t key : player->storageChanges) {
+		if (auto value = player->getStorageValue(key)) {
+			if (!storageQuery.addRow(fmt::format("{:d}, {:d}, {:d}", player->getGUID(), key, value.value()))) {
+				return false;
+			}
+		} else {
+			removedStorageKeys.push_back(key);
+		}
 	}
 
-	if (!saveItems(player, itemList, storeInboxQuery, propWriteStream)) {
+	if (!storageQuery.execute()) {
 		return false;
 	}
 
-	if (!db.executeQuery(fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {:d}", player->getGUID()))) {
+	if (!removedStorageKeys.empty() && !db.executeQuery(fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {:d} AND `key` IN ({:s})", player->getGUID(), joinIds(removedStorageKeys, [](uint32_t key) { return key; })))) {
 		return false;
 	}
 
-	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+	// save the custom skills changed since the last save
+	DBInsert customSkillsQuery("INSERT INTO `player_custom_skills` (`player_id`, `skill_id`, `value`) VALUES ", " ON DUPLICATE KEY UPDATE `value` = VALUES(`value`)");
 
-	for (const auto& [key, value] : player->getStorageMap()) {
-		if (!storageQuery.addRow(fmt::format("{:d}, {:d}, {:d}", player->getGUID(), key, value))) {
+	for (uint16_t skillId = 0; skillId <= CUSTOMSKILL_LAST; ++skillId) {
+		if (player->customSkillChanges.test(skillId) && !customSkillsQuery.addRow(fmt::format("{:d}, {:d}, {:d}", player->getGUID(), skillId, player->customSkills[skillId]))) {
 			return false;
 		}
 	}
 
-	if (!storageQuery.execute()) {
+	if (!customSkillsQuery.execute()) {
 		return false;
 	}
 
@@ -825,7 +934,13 @@ bool IOLoginData::savePlayer(Player* player) {
 	}
 
 	//End the transaction
-	return transaction.commit();
+	if (!transaction.commit()) {
+		return false;
+	}
+
+	player->storageChanges.clear();
+	player->customSkillChanges.reset();
+	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid) {
@@ -911,6 +1026,67 @@ void IOLoginData::increaseBankBalance(uint32_t guid, uint64_t bankBalance) {
 	Database::getInstance().executeQuery(fmt::format("UPDATE `players` SET `balance` = `balance` + {:d} WHERE `id` = {:d}", bankBalance, guid));
 }
 
+std::map<uint32_t, uint64_t> IOLoginData::getBankBalances(const std::vector<uint32_t>& guids) {
+	std::map<uint32_t, uint64_t> balances;
+	if (guids.empty()) {
+		return balances;
+	}
+
+	DBResult_ptr result = Database::getInstance().storeQuery(fmt::format("SELECT `id`, `balance` FROM `players` WHERE `id` IN ({:s})", joinIds(guids, [](uint32_t guid) { return guid; })));
+	if (result) {
+		do {
+			balances.emplace(result->getNumber<uint32_t>("id"), result->getNumber<uint64_t>("balance"));
+		} while (result->next());
+	}
+	return balances;
+}
+
+bool IOLoginData::decreaseBankBalances(const std::map<uint32_t, uint64_t>& amounts) {
+	if (amounts.empty()) {
+		return true;
+	}
+
+	std::string cases;
+	for (const auto& [guid, amount] : amounts) {
+		cases += fmt::format(" WHEN {:d} THEN {:d}", guid, amount);
+	}
+
+	return Database::getInstance().executeQuery(fmt::format("UPDATE `players` SET `balance` = `balance` - CASE `id`{:s} END WHERE `id` IN ({:s})", cases, joinIds(amounts, [](const auto& it) { return it.first; })));
+}
+
+bool IOLoginData::addInboxItems(const std::vector<std::pair<uint32_t, const Item*>>& items) {
+	if (items.empty()) {
+		return true;
+	}
+
+	Database& db = Database::getInstance();
+
+	// new rows continue after the highest sid in use, as saveItem starts at 100
+	std::map<uint32_t, uint32_t> runningIds;
+	for (const auto& it : items) {
+		runningIds.emplace(it.first, 100);
+	}
+
+	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `player_id`, MAX(`sid`) AS `sid` FROM `player_inboxitems` WHERE `player_id` IN ({:s}) GROUP BY `player_id`", joinIds(runningIds, [](const auto& it) { return it.first; })));
+	if (result) {
+		do {
+			runningIds[result->getNumber<uint32_t>("player_id")] = std::max<uint32_t>(100, result->getNumber<uint32_t>("sid"));
+		} while (result->next());
+	}
+
+	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
+	PropWriteStream propWriteStream;
+	for (const auto& [guid, item] : items) {
+		propWriteStream.clear();
+		item->serializeAttr(propWriteStream);
+
+		if (!inboxQuery.addRow(fmt::format("{:d}, {:d}, {:d}, {:d}, {:d}", guid, 0, ++runningIds[guid], item->getID(), item->getSubType()), propWriteStream.getStream())) {
+			return false;
+		}
+	}
+	return inboxQuery.execute();
+}
+
 bool IOLoginData::hasBiddedOnHouse(uint32_t guid) {
 	Database& db = Database::getInstance();
 	return db.storeQuery(fmt::format("SELECT `id` FROM `houses` WHERE `highest_bidder` = {:d} LIMIT 1", guid)).get();
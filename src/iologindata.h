@@ -6,35 +6,80 @@
 
 #include "database.h"
 #include "enums.h"
+#include "guild.h"
 
 class Item;
 class Player;
 class PropWriteStream;
 
-using ItemBlockList = std::list<std::pair<int32_t, Item*>>;
-
 struct VIPEntry;
 
+// Data of a player loaded away from the dispatcher that still has to be
+// applied to shared game state, see IOLoginData::bindPlayer
+struct PlayerBindings {
+	uint16_t groupId = 0;
+	uint16_t vocationId = 0;
+	uint32_t townId = 0;
+	std::vector<uint16_t> mountIds;
+	std::vector<uint32_t> vipGuids;
+	time_t skullTime = 0;
+	uint16_t skull = 0;
+
+	// set by the caller to a guild the game has cached, when the player is a
+	// member of it only the player's rank is loaded instead of the whole guild
+	uint32_t cachedGuildId = 0;
+	uint32_t guildId = 0;
+	Guild_ptr guild = nullptr;
+	GuildRank_ptr guildRank = nullptr;
+	uint32_t guildRankId = 0;
+	uint32_t guildMemberCount = 0;
+	std::vector<std::pair<uint32_t, int32_t>> storageValues;
+};
+
+// Account data of a character the login checks need before the player is loaded
+struct PlayerPreload {
+	uint32_t guid = 0;
+	uint32_t accountId = 0;
+	uint16_t groupId = 0;
+	uint32_t guildId = 0;
+	AccountType_t accountType = ACCOUNT_TYPE_NORMAL;
+	time_t premiumEndsAt = 0;
+};
+
 class IOLoginData {
 	public:
-		static std::pair<uint32_t, std::string> gameworldAuthentication(std::string_view accountName, std::string_view password, std::string_view characterName, std::string_view token, uint32_t tokenTime);
+		static std::pair<uint32_t, std::string> gameworldAuthentication(Database& db, std::string_view accountName, std::string_view password, std::string_view characterName, std::string_view token, uint32_t tokenTime);
 		static uint32_t getAccountIdByPlayerName(const std::string& playerName);
 		static uint32_t getAccountIdByPlayerId(uint32_t playerId);
 
 		static AccountType_t getAccountType(uint32_t accountId);
 		static void setAccountType(uint32_t accountId, AccountType_t accountType);
 		static void updateOnlineStatus(uint32_t guid, bool login);
-		static bool preloadPlayer(Player* player, const std::string& name);
+		// preloadPlayer only queries the database, applyPreload resolves the group on the dispatcher
+		static bool preloadPlayer(Database& db, const std::string& name, PlayerPreload& preload);
+		static bool applyPreload(Player* player, const PlayerPreload& preload);
 
 		static bool loadPlayerById(Player* player, uint32_t id);
 		static bool loadPlayerByName(Player* player, const std::string& name);
 		static bool loadPlayer(Player* player, DBResult_ptr result);
+
+		// the two stages of loadPlayerById, the first one is safe to run on the
+		// database thread as long as the player is not known to the game yet
+		static bool loadPlayerById(Database& db, Player* player, uint32_t id, PlayerBindings& bindings);
+		static bool bindPlayer(Player* player, PlayerBindings& bindings);
+
 		static bool savePlayer(Player* player);
 		static uint32_t getGuidByName(const std::string& name);
 		static bool getGuidByNameEx(uint32_t& guid, bool& specialVip, std::string& name);
 		static std::string getNameByGuid(uint32_t guid);
 		static bool formatPlayerName(std::string& name);
 		static void increaseBankBalance(uint32_t guid, uint64_t bankBalance);
+
+		// changes to offline players that only touch the affected columns and
+		// rows, each call is a single statement for all given players
+		static std::map<uint32_t, uint64_t> getBankBalances(const std::vector<uint32_t>& guids);
+		static bool decreaseBankBalances(const std::map<uint32_t, uint64_t>& amounts);
+		static bool addInboxItems(const std::vector<std::pair<uint32_t, const Item*>>& items);
 		static bool hasBiddedOnHouse(uint32_t guid);
 
 		static std::forward_list<VIPEntry> getVIPEntries(uint32_t accountId);
@@ -47,8 +92,10 @@ class IOLoginData {
 	private:
 		using ItemMap = std::map<uint32_t, std::pair<Item*, uint32_t>>;
 
+		static bool loadPlayer(Database& db, Player* player, DBResult_ptr result, PlayerBindings& bindings);
 		static void loadItems(ItemMap& itemMap, DBResult_ptr result);
-		static bool saveItems(const Player* player, const ItemBlockList& itemList, DBInsert& query_insert, PropWriteStream& propWriteStream);
+		// adds the rows of an item and everything inside it, numbered depth first
+		static bool saveItem(const Player* player, int32_t pid, const Item* item, int32_t& runningId, DBInsert& query_insert, PropWriteStream& propWriteStream);
 };
 
 #endif // FS_IOLOGINDATA_H
\ No newline at end of file
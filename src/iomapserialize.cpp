@@ -6,10 +6,79 @@
 #include "iomapserialize.h"
 
 #include "bed.h"
+#include "databasetasks.h"
 #include "game.h"
 #include "housetile.h"
 
 extern Game g_game;
+extern Dispatcher g_dispatcher;
+
+namespace {
+
+struct HouseItems {
+	HouseItems(uint32_t houseId, uint32_t version) : houseId(houseId), version(version) {}
+
+	uint32_t houseId;
+	uint32_t version;
+	std::vector<std::string> tiles;
+};
+
+bool writeHouseItems(Database& db, const std::vector<HouseItems>& changedHouses) {
+	DBTransaction transaction(db);
+	if (!transaction.begin()) {
+		return false;
+	}
+
+	std::string houseIds;
+	for (const HouseItems& houseItems : changedHouses) {
+		if (!houseIds.empty()) {
+			houseIds.push_back(',');
+		}
+		houseIds += std::to_string(houseItems.houseId);
+	}
+
+	// replace the rows of the changed houses only
+	if (!db.executeQuery(fmt::format("DELETE FROM `tile_store` WHERE `house_id` IN ({:s})", houseIds))) {
+		return false;
+	}
+
+	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ", "", db);
+	for (const HouseItems& houseItems : changedHouses) {
+		for (const std::string& tile : houseItems.tiles) {
+			if (!stmt.addRow(fmt::format("{:d}, {:s}", houseItems.houseId, db.escapeString(tile)))) {
+				return false;
+			}
+		}
+	}
+
+	if (!stmt.execute()) {
+		return false;
+	}
+	return transaction.commit();
+}
+
+bool saveChangedHouses(Database& db, const std::vector<HouseItems>& changedHouses, size_t tileCount) {
+	int64_t start = OTSYS_TIME();
+
+	for (uint32_t tries = 0; tries < 3; tries++) {
+		if (writeHouseItems(db, changedHouses)) {
+			std::cout << "> Saved items of " << changedHouses.size() << " houses (" << tileCount << " rows) in: " <<
+			          (OTSYS_TIME() - start) / (1000.) << " s" << std::endl;
+			return true;
+		}
+	}
+	return false;
+}
+
+void markItemsSaved(const std::vector<HouseItems>& changedHouses) {
+	for (const HouseItems& houseItems : changedHouses) {
+		if (House* house = g_game.map.houses.getHouse(houseItems.houseId)) {
+			house->setItemsSaved(houseItems.version);
+		}
+	}
+}
+
+}
 
 void IOMapSerialize::loadHouseItems(Map* map) {
 	int64_t start = OTSYS_TIME();
@@ -48,48 +117,72 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 	std::cout << "> Loaded house items in: " << (OTSYS_TIME() - start) / (1000.) << " s" << std::endl;
 }
 
-bool IOMapSerialize::saveHouseItems() {
+bool IOMapSerialize::saveHouseItems(std::function<void(bool)> callback/* = nullptr*/) {
 	int64_t start = OTSYS_TIME();
-	Database& db = Database::getInstance();
 
-	//Start the transaction
-	DBTransaction transaction;
-	if (!transaction.begin()) {
-		return false;
-	}
-
-	//clear old tile data
-	if (!db.executeQuery("DELETE FROM `tile_store`")) {
-		return false;
-	}
-
-	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
+	// only houses with item changes since their last save are serialized here,
+	// with a callback the rows are replaced on the database thread
+	std::vector<HouseItems> changedHouses;
+	size_t tileCount = 0;
 
 	PropWriteStream stream;
 	for (const auto& it : g_game.map.houses.getHouses()) {
-		//save house items
 		House* house = it.second;
+		if (!house->hasUnsavedItems()) {
+			continue;
+		}
+
+		HouseItems& houseItems = changedHouses.emplace_back(house->getId(), house->getItemsVersion());
 		for (HouseTile* tile : house->getTiles()) {
 			saveTile(stream, tile);
 
 			if (auto attributes = stream.getStream(); !attributes.empty()) {
-				if (!stmt.addRow(fmt::format("{:d}, {:s}", house->getId(), db.escapeString(attributes)))) {
-					return false;
-				}
+				houseItems.tiles.emplace_back(attributes);
 				stream.clear();
 			}
 		}
+		tileCount += houseItems.tiles.size();
 	}
 
-	if (!stmt.execute()) {
-		return false;
+	std::cout << "> Serialized items of " << changedHouses.size() << " changed houses (" << tileCount << " tiles) in: " <<
+	          (OTSYS_TIME() - start) / (1000.) << " s" << std::endl;
+
+	if (changedHouses.empty()) {
+		if (callback) {
+			callback(true);
+		}
+		return true;
 	}
 
-	//End the transaction
-	bool success = transaction.commit();
-	std::cout << "> Saved house items in: " <<
-	          (OTSYS_TIME() - start) / (1000.) << " s" << std::endl;
-	return success;
+	if (callback) {
+		auto houses = std::make_shared<std::vector<HouseItems>>(std::move(changedHouses));
+		bool queued = g_databaseTasks.addJob([houses, tileCount, callback](Database& db) {
+			bool saved = saveChangedHouses(db, *houses, tileCount);
+			g_dispatcher.addTask([houses, saved, callback]() {
+				if (saved) {
+					markItemsSaved(*houses);
+				}
+				callback(saved);
+			});
+		});
+
+		if (queued) {
+			return true;
+		}
+
+		// the database thread is not running, write on this thread instead
+		changedHouses = std::move(*houses);
+	}
+
+	bool saved = saveChangedHouses(Database::getInstance(), changedHouses, tileCount);
+	if (saved) {
+		markItemsSaved(changedHouses);
+	}
+
+	if (callback) {
+		callback(saved);
+	}
+	return saved;
 }
 
 bool IOMapSerialize::loadContainer(PropStream& propStream, Container* container) {
@@ -346,6 +439,7 @@ bool IOMapSerialize::saveHouse(House* house) {
 	}
 
 	uint32_t houseId = house->getId();
+	uint32_t version = house->getItemsVersion();
 
 	//clear old tile data
 	if (!db.executeQuery(fmt::format("DELETE FROM `tile_store` WHERE `house_id` = {:d}", houseId))) {
@@ -371,5 +465,10 @@ bool IOMapSerialize::saveHouse(House* house) {
 	}
 
 	//End the transaction
-	return transaction.commit();
+	if (!transaction.commit()) {
+		return false;
+	}
+
+	house->setItemsSaved(version);
+	return true;
 }
\ No newline at end of file
@@ -16,7 +16,9 @@ class Tile;
 class IOMapSerialize {
 	public:
 		static void loadHouseItems(Map* map);
-		static bool saveHouseItems();
+		// without a callback the items are written before returning, otherwise
+		// the callback receives the result of the write on the dispatcher
+		static bool saveHouseItems(std::function<void(bool)> callback = nullptr);
 		static bool loadHouseInfo();
 		static bool saveHouseInfo();
 
@@ -235,6 +235,7 @@ void Item::onRemoved() {
 void Item::setID(uint16_t newid) {
 	const ItemType& prevIt = Item::items[id];
 	id = newid;
+	resetTileItemsEncoding();
 
 	const ItemType& it = Item::items[newid];
 	uint32_t newDuration = it.decayTime * 1000;
@@ -252,6 +253,12 @@ void Item::setID(uint16_t newid) {
 	}
 }
 
+void Item::resetTileItemsEncoding() const {
+	if (parent && parent->getTile() == parent) {
+		parent->getTile()->resetItemsEncoding();
+	}
+}
+
 Cylinder* Item::getTopParent() {
 	Cylinder* aux = getParent();
 	Cylinder* prevaux = dynamic_cast<Cylinder*>(this);
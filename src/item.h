@@ -593,6 +593,9 @@ class Item : virtual public Thing {
 		}
 		void setIntAttr(itemAttrTypes type, int64_t value) {
 			getAttributes()->setIntAttr(type, value);
+			if (type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+				resetTileItemsEncoding();
+			}
 		}
 		void increaseIntAttr(itemAttrTypes type, int64_t value) {
 			getAttributes()->increaseIntAttr(type, value);
@@ -601,6 +604,9 @@ class Item : virtual public Thing {
 		void removeAttribute(itemAttrTypes type) {
 			if (attributes) {
 				attributes->removeAttribute(type);
+				if (type == ITEM_ATTRIBUTE_FLUIDTYPE) {
+					resetTileItemsEncoding();
+				}
 			}
 		}
 		bool hasAttribute(itemAttrTypes type) const {
@@ -950,6 +956,7 @@ class Item : virtual public Thing {
 		}
 		void setItemCount(uint8_t n) {
 			count = n;
+			resetTileItemsEncoding();
 		}
 
 		static uint32_t countByType(const Item* i, int32_t subType) {
@@ -1041,6 +1048,9 @@ class Item : virtual public Thing {
 	private:
 		std::string getWeightDescription(uint32_t weight) const;
 
+		// drops the cached client encoding of the tile lying directly under the item
+		void resetTileItemsEncoding() const;
+
 		std::unique_ptr<ItemAttributes> attributes;
 
 		uint32_t referenceCounter = 0;
@@ -1260,7 +1260,7 @@ void Items::parseItemNode(const pugi::xml_node& itemNode, uint16_t id) {
 							} else if (tmpStrValue == "damage") {
 								damage = -pugi::cast<int32_t>(subValueAttribute.value());
 								if (start > 0) {
-									std::list<int32_t> damageList;
+									std::vector<int32_t> damageList;
 									ConditionDamage::generateDamageList(damage, start, damageList);
 									for (int32_t damageValue : damageList) {
 										conditionDamage->addDamage(1, ticks, -damageValue);
@@ -906,6 +906,105 @@ static Outfit getOutfitClass(lua_State* L, int32_t arg) {
 	return Outfit(name, lookType, premium, unlocked);
 }
 
+static bool getMapChunkOffset(lua_State* L, int32_t arg, const MapChunk& chunk, Position& offset) {
+	lua_getfield(L, arg, "pos");
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		return false;
+	}
+
+	offset = lua::getPosition(L, lua_gettop(L));
+	lua_pop(L, 1);
+	return offset.x < chunk.sizeX && offset.y < chunk.sizeY;
+}
+
+static MapChunk getMapChunk(lua_State* L, int32_t arg) {
+	MapChunk chunk;
+	chunk.name = lua::getFieldString(L, arg, "name");
+	chunk.ground = lua::getField<uint16_t>(L, arg, "ground", 0);
+	lua_pop(L, 2);
+
+	lua_getfield(L, arg, "size");
+	if (lua_istable(L, -1)) {
+		const int32_t size = lua_gettop(L);
+		chunk.sizeX = std::max<uint16_t>(lua::getField<uint16_t>(L, size, "x", 1), 1);
+		chunk.sizeY = std::max<uint16_t>(lua::getField<uint16_t>(L, size, "y", 1), 1);
+		lua_pop(L, 2);
+	}
+	lua_pop(L, 1);
+
+	// entries placed outside of the chunk are skipped
+	lua_getfield(L, arg, "items");
+	if (lua_istable(L, -1)) {
+		lua_pushnil(L);
+		while (lua_next(L, -2) != 0) {
+			const int32_t entry = lua_gettop(L);
+			MapChunkItem item;
+			if (lua_istable(L, entry) && getMapChunkOffset(L, entry, chunk, item.offset)) {
+				item.id = lua::getField<uint16_t>(L, entry, "id");
+				item.count = lua::getField<uint16_t>(L, entry, "count", 1);
+				item.actionId = lua::getField<uint16_t>(L, entry, "actionId", 0);
+				item.effect = lua::getField<MagicEffectClasses>(L, entry, "effect", CONST_ME_NONE);
+				lua_pop(L, 4);
+
+				lua_getfield(L, entry, "container");
+				if (lua_istable(L, -1)) {
+					lua_pushnil(L);
+					while (lua_next(L, -2) != 0) {
+						if (lua_istable(L, -1)) {
+							const int32_t content = lua_gettop(L);
+							item.contents.emplace_back(lua::getField<uint16_t>(L, content, "id"), lua::getField<uint16_t>(L, content, "count", 1));
+							lua_pop(L, 2);
+						}
+						lua_pop(L, 1);
+					}
+				}
+				lua_pop(L, 1);
+
+				chunk.items.push_back(std::move(item));
+			}
+			lua_pop(L, 1);
+		}
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, arg, "monsters");
+	if (lua_istable(L, -1)) {
+		lua_pushnil(L);
+		while (lua_next(L, -2) != 0) {
+			const int32_t entry = lua_gettop(L);
+			MapChunkMonster monster;
+			if (lua_istable(L, entry) && getMapChunkOffset(L, entry, chunk, monster.offset)) {
+				monster.name = lua::getFieldString(L, entry, "name");
+				monster.effect = lua::getField<MagicEffectClasses>(L, entry, "effect", CONST_ME_TELEPORT);
+				lua_pop(L, 2);
+
+				chunk.monsters.push_back(std::move(monster));
+			}
+			lua_pop(L, 1);
+		}
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, arg, "effects");
+	if (lua_istable(L, -1)) {
+		lua_pushnil(L);
+		while (lua_next(L, -2) != 0) {
+			const int32_t entry = lua_gettop(L);
+			MapChunkEffect effect;
+			if (lua_istable(L, entry) && getMapChunkOffset(L, entry, chunk, effect.offset)) {
+				effect.effect = lua::getField<MagicEffectClasses>(L, entry, "effect");
+				lua_pop(L, 1);
+
+				chunk.effects.push_back(effect);
+			}
+			lua_pop(L, 1);
+		}
+	}
+	lua_pop(L, 1);
+	return chunk;
+}
+
 static LuaVariant getVariant(lua_State* L, int32_t arg) {
 	LuaVariant var;
 	switch (lua::getField<LuaVariantType_t>(L, arg, "type")) {
@@ -1107,6 +1206,16 @@ static void pushLoot(lua_State* L, const std::vector<LootBlock>& lootList) {
 	}
 }
 
+static void updateEquipmentAttributes(const Item* item) {
+	if (Cylinder* parent = item->getParent()) {
+		if (Creature* creature = parent->getCreature()) {
+			if (Player* player = creature->getPlayer()) {
+				player->updateEquipmentAttributes();
+			}
+		}
+	}
+}
+
 #define registerEnum(L, value) {std::string enumName = #value; registerGlobalVariable(L, enumName.substr(enumName.find_last_of(':') + 1), value); }
 #define registerEnumIn(L, tableName, value) { std::string enumName = #value; registerVariable(L, tableName, enumName.substr(enumName.find_last_of(':') + 1), value); }
 
@@ -2148,6 +2257,7 @@ void LuaScriptInterface::registerFunctions() {
 	registerEnumIn(L, "configKeys", ConfigManager::PROTECTION_LEVEL)
 	registerEnumIn(L, "configKeys", ConfigManager::DEATH_LOSE_PERCENT)
 	registerEnumIn(L, "configKeys", ConfigManager::STATUSQUERY_TIMEOUT)
+	registerEnumIn(L, "configKeys", ConfigManager::STATUS_CACHE_TIME)
 	registerEnumIn(L, "configKeys", ConfigManager::FRAG_TIME)
 	registerEnumIn(L, "configKeys", ConfigManager::WHITE_SKULL_TIME)
 	registerEnumIn(L, "configKeys", ConfigManager::GAME_PORT)
@@ -2196,6 +2306,11 @@ void LuaScriptInterface::registerFunctions() {
 	registerMethod(L, "Game", "getMonsters", LuaScriptInterface::luaGameGetMonsters);
 
 	registerMethod(L, "Game", "getExperienceStage", LuaScriptInterface::luaGameGetExperienceStage);
+	registerMethod(L, "Game", "getCombatMessagesSaved", LuaScriptInterface::luaGameGetCombatMessagesSaved);
+	registerMethod(L, "Game", "getMonsterTargetChecksSaved", LuaScriptInterface::luaGameGetMonsterTargetChecksSaved);
+	registerMethod(L, "Game", "getBroadcastEncodesSaved", LuaScriptInterface::luaGameGetBroadcastEncodesSaved);
+	registerMethod(L, "Game", "getScriptLookupsSkipped", LuaScriptInterface::luaGameGetScriptLookupsSkipped);
+	registerMethod(L, "Game", "getLoginStats", LuaScriptInterface::luaGameGetLoginStats);
 	registerMethod(L, "Game", "getExperienceForLevel", LuaScriptInterface::luaGameGetExperienceForLevel);
 	registerMethod(L, "Game", "getMonsterCount", LuaScriptInterface::luaGameGetMonsterCount);
 	registerMethod(L, "Game", "getPlayerCount", LuaScriptInterface::luaGameGetPlayerCount);
@@ -2209,6 +2324,8 @@ void LuaScriptInterface::registerFunctions() {
 
 	registerMethod(L, "Game", "getOutfits", LuaScriptInterface::luaGameGetOutfits);
 	registerMethod(L, "Game", "getMounts", LuaScriptInterface::luaGameGetMounts);
+	registerMethod(L, "Game", "getCustomAttributes", LuaScriptInterface::luaGameGetCustomAttributes);
+	registerMethod(L, "Game", "getCustomSkills", LuaScriptInterface::luaGameGetCustomSkills);
 
 	registerMethod(L, "Game", "getGameState", LuaScriptInterface::luaGameGetGameState);
 	registerMethod(L, "Game", "setGameState", LuaScriptInterface::luaGameSetGameState);
@@ -2224,6 +2341,9 @@ void LuaScriptInterface::registerFunctions() {
 	registerMethod(L, "Game", "createMonster", LuaScriptInterface::luaGameCreateMonster);
 	registerMethod(L, "Game", "createNpc", LuaScriptInterface::luaGameCreateNpc);
 	registerMethod(L, "Game", "createTile", LuaScriptInterface::luaGameCreateTile);
+	registerMethod(L, "Game", "registerMapChunk", LuaScriptInterface::luaGameRegisterMapChunk);
+	registerMethod(L, "Game", "createMapChunk", LuaScriptInterface::luaGameCreateMapChunk);
+	registerMethod(L, "Game", "removeMapChunk", LuaScriptInterface::luaGameRemoveMapChunk);
 	registerMethod(L, "Game", "createMonsterType", LuaScriptInterface::luaGameCreateMonsterType);
 
 	registerMethod(L, "Game", "startEvent", LuaScriptInterface::luaGameStartEvent);
@@ -2527,6 +2647,8 @@ void LuaScriptInterface::registerFunctions() {
 
 	registerMethod(L, "Creature", "getStorageValue", LuaScriptInterface::luaCreatureGetStorageValue);
 	registerMethod(L, "Creature", "setStorageValue", LuaScriptInterface::luaCreatureSetStorageValue);
+	registerMethod(L, "Creature", "getStorageValues", LuaScriptInterface::luaCreatureGetStorageValues);
+	registerMethod(L, "Creature", "setStorageValues", LuaScriptInterface::luaCreatureSetStorageValues);
 
 	// Player
 	registerClass(L, "Player", "Creature", LuaScriptInterface::luaPlayerCreate);
@@ -2576,6 +2698,10 @@ void LuaScriptInterface::registerFunctions() {
 	registerMethod(L, "Player", "getSkillLevel", LuaScriptInterface::luaPlayerGetSkillLevel);
 	registerMethod(L, "Player", "getEffectiveSkillLevel", LuaScriptInterface::luaPlayerGetEffectiveSkillLevel);
 	registerMethod(L, "Player", "getSkillPercent", LuaScriptInterface::luaPlayerGetSkillPercent);
+	registerMethod(L, "Player", "getCustomAttribute", LuaScriptInterface::luaPlayerGetCustomAttribute);
+	registerMethod(L, "Player", "getCustomSkill", LuaScriptInterface::luaPlayerGetCustomSkill);
+	registerMethod(L, "Player", "setCustomSkill", LuaScriptInterface::luaPlayerSetCustomSkill);
+	registerMethod(L, "Player", "addCustomSkill", LuaScriptInterface::luaPlayerAddCustomSkill);
 	registerMethod(L, "Player", "getSkillTries", LuaScriptInterface::luaPlayerGetSkillTries);
 	registerMethod(L, "Player", "addSkillTries", LuaScriptInterface::luaPlayerAddSkillTries);
 	registerMethod(L, "Player", "removeSkillTries", LuaScriptInterface::luaPlayerRemoveSkillTries);
@@ -2730,6 +2856,7 @@ void LuaScriptInterface::registerFunctions() {
 
         registerMethod(L, "Monster", "getLevel", LuaScriptInterface::luaMonsterGetLevel);
         registerMethod(L, "Monster", "setLevel", LuaScriptInterface::luaMonsterSetLevel);
+	registerMethod(L, "Monster", "getLoot", LuaScriptInterface::luaMonsterGetLoot);
 
 	registerMethod(L, "Monster", "rename", LuaScriptInterface::luaMonsterRename);
 
@@ -4380,6 +4507,44 @@ int LuaScriptInterface::luaGameGetExperienceStage(lua_State* L) {
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetCombatMessagesSaved(lua_State* L) {
+	// Game.getCombatMessagesSaved()
+	lua_pushnumber(L, g_game.getCombatMessagesSaved());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetMonsterTargetChecksSaved(lua_State* L) {
+	// Game.getMonsterTargetChecksSaved()
+	lua_pushnumber(L, Monster::targetChecksSaved);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetBroadcastEncodesSaved(lua_State* L) {
+	// Game.getBroadcastEncodesSaved()
+	lua_pushnumber(L, g_game.getBroadcastEncodesSaved());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetScriptLookupsSkipped(lua_State* L) {
+	// Game.getScriptLookupsSkipped()
+	lua_createtable(L, 0, 2);
+	setField(L, "actions", g_actions->getLookupsSkipped());
+	setField(L, "movements", g_moveEvents->getLookupsSkipped());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetLoginStats(lua_State* L) {
+	// Game.getLoginStats()
+	const LoginStats& stats = g_game.getLoginStats();
+	lua_createtable(L, 0, 5);
+	setField(L, "logins", stats.logins);
+	setField(L, "authenticateTime", stats.authenticateTime);
+	setField(L, "loadTime", stats.loadTime);
+	setField(L, "placeTime", stats.placeTime);
+	setField(L, "maxTime", stats.maxTime);
+	return 1;
+}
+
 int LuaScriptInterface::luaGameGetExperienceForLevel(lua_State* L) {
 	// Game.getExperienceForLevel(level)
 	const uint32_t level = lua::getNumber<uint32_t>(L, 1);
@@ -4516,6 +4681,35 @@ int LuaScriptInterface::luaGameGetMounts(lua_State* L) {
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetCustomAttributes(lua_State* L) {
+	// Game.getCustomAttributes()
+	const auto& attributes = g_game.customAttributes.getAttributes();
+	lua_createtable(L, 0, attributes.size());
+	for (const auto& attribute : attributes) {
+		lua_createtable(L, 0, 3);
+
+		setField(L, "name", attribute.name);
+		setField(L, "description", attribute.description);
+		setField(L, "group", attribute.group);
+		lua_rawseti(L, -2, attribute.id);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetCustomSkills(lua_State* L) {
+	// Game.getCustomSkills()
+	const auto& skills = g_game.customSkills.getSkills();
+	lua_createtable(L, 0, skills.size());
+	for (const auto& skill : skills) {
+		lua_createtable(L, 0, 2);
+
+		setField(L, "name", skill.name);
+		setField(L, "description", skill.description);
+		lua_rawseti(L, -2, skill.id);
+	}
+	return 1;
+}
+
 int LuaScriptInterface::luaGameGetGameState(lua_State* L) {
 	// Game.getGameState()
 	lua_pushnumber(L, g_game.getGameState());
@@ -4722,6 +4916,45 @@ int LuaScriptInterface::luaGameCreateTile(lua_State* L) {
 	return 1;
 }
 
+int LuaScriptInterface::luaGameRegisterMapChunk(lua_State* L) {
+	// Game.registerMapChunk(chunk)
+	if (!lua_istable(L, 1)) {
+		lua::pushBoolean(L, false);
+		return 1;
+	}
+
+	MapChunk chunk = getMapChunk(L, 1);
+	if (chunk.name.empty()) {
+		reportErrorFunc(L, "Map chunks need a name.");
+		lua::pushBoolean(L, false);
+		return 1;
+	}
+
+	g_game.mapChunks.addChunk(std::move(chunk));
+	lua::pushBoolean(L, true);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameCreateMapChunk(lua_State* L) {
+	// Game.createMapChunk(name, position[, rotation = 0])
+	const MapChunk* chunk = g_game.mapChunks.getChunk(lua::getString(L, 1));
+	if (!chunk) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	const Position& position = lua::getPosition(L, 2);
+	uint16_t rotation = lua::getNumber<uint16_t>(L, 3, 0);
+	lua_pushnumber(L, g_game.mapChunks.createInstance(*chunk, position, rotation));
+	return 1;
+}
+
+int LuaScriptInterface::luaGameRemoveMapChunk(lua_State* L) {
+	// Game.removeMapChunk(instanceId)
+	lua::pushBoolean(L, g_game.mapChunks.removeInstance(lua::getNumber<uint32_t>(L, 1)));
+	return 1;
+}
+
 int LuaScriptInterface::luaGameCreateMonsterType(lua_State* L) {
 	// Game.createMonsterType(name)
 	if (lua::getScriptEnv()->getScriptInterface() != &g_scripts->getScriptInterface()) {
@@ -4742,7 +4975,7 @@ int LuaScriptInterface::luaGameCreateMonsterType(lua_State* L) {
 		monsterType->name = name;
 		monsterType->nameDescription = "a " + name;
 	} else {
-		monsterType->info.lootItems.clear();
+		monsterType->clearLoot();
 		monsterType->info.attackSpells.clear();
 		monsterType->info.defenseSpells.clear();
 		monsterType->info.scripts.clear();
@@ -6386,6 +6619,7 @@ int LuaScriptInterface::luaItemSetActionId(lua_State* L) {
 	Item* item = lua::getUserdata<Item>(L, 1);
 	if (item) {
 		item->setActionId(actionId);
+		House::onItemChanged(item);
 		lua::pushBoolean(L, true);
 	} else {
 		lua_pushnil(L);
@@ -6594,9 +6828,11 @@ int LuaScriptInterface::luaItemSetAttribute(lua_State* L) {
 		}
 
 		item->setIntAttr(attribute, lua::getNumber<int32_t>(L, 3));
+		House::onItemChanged(item);
 		lua::pushBoolean(L, true);
 	} else if (ItemAttributes::isStrAttrType(attribute)) {
 		item->setStrAttr(attribute, lua::getString(L, 3));
+		House::onItemChanged(item);
 		lua::pushBoolean(L, true);
 	} else {
 		lua_pushnil(L);
@@ -6624,6 +6860,7 @@ int LuaScriptInterface::luaItemRemoveAttribute(lua_State* L) {
 	bool ret = attribute != ITEM_ATTRIBUTE_UNIQUEID;
 	if (ret) {
 		item->removeAttribute(attribute);
+		House::onItemChanged(item);
 	} else {
 		reportErrorFunc(L, "Attempt to erase protected key \"uid\"");
 	}
@@ -6693,6 +6930,8 @@ int LuaScriptInterface::luaItemSetCustomAttribute(lua_State* L) {
 	}
 
 	item->setCustomAttribute(key, val);
+	House::onItemChanged(item);
+	updateEquipmentAttributes(item);
 	lua::pushBoolean(L, true);
 	return 1;
 }
@@ -6711,7 +6950,11 @@ int LuaScriptInterface::luaItemRemoveCustomAttribute(lua_State* L) {
 		lua::pushBoolean(L, item->removeCustomAttribute(lua::getString(L, 2)));
 	} else {
 		lua_pushnil(L);
+		return 1;
 	}
+
+	House::onItemChanged(item);
+	updateEquipmentAttributes(item);
 	return 1;
 }
 
@@ -8232,6 +8475,59 @@ int LuaScriptInterface::luaCreatureSetStorageValue(lua_State* L) {
 	return 1;
 }
 
+int LuaScriptInterface::luaCreatureGetStorageValues(lua_State* L) {
+	// creature:getStorageValues(keys)
+	Creature* creature = lua::getUserdata<Creature>(L, 1);
+	if (!creature || !lua_istable(L, 2)) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_newtable(L);
+	lua_pushnil(L);
+	while (lua_next(L, 2) != 0) {
+		uint32_t key = lua::getNumber<uint32_t>(L, -1);
+		lua_pop(L, 1);
+
+		if (auto storage = creature->getStorageValue(key)) {
+			lua_pushnumber(L, key);
+			lua_pushnumber(L, storage.value());
+			lua_rawset(L, -4);
+		}
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaCreatureSetStorageValues(lua_State* L) {
+	// creature:setStorageValues({[key] = value, ...})
+	Creature* creature = lua::getUserdata<Creature>(L, 1);
+	if (!creature || !lua_istable(L, 2)) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	std::vector<std::pair<uint32_t, int32_t>> values;
+	lua_pushnil(L);
+	while (lua_next(L, 2) != 0) {
+		uint32_t key = lua::getNumber<uint32_t>(L, -2);
+		if (IS_IN_KEYRANGE(key, RESERVED_RANGE)) {
+			reportErrorFunc(L, fmt::format("Accessing reserved range: {:d}", key));
+			lua_pop(L, 2);
+			lua::pushBoolean(L, false);
+			return 1;
+		}
+
+		values.emplace_back(key, lua::getNumber<int32_t>(L, -1));
+		lua_pop(L, 1);
+	}
+
+	for (const auto& [key, value] : values) {
+		creature->setStorageValue(key, value);
+	}
+	lua::pushBoolean(L, true);
+	return 1;
+}
+
 // Player
 int LuaScriptInterface::luaPlayerCreate(lua_State* L) {
 	// Player(id or guid or name or userdata)
@@ -8685,6 +8981,55 @@ int LuaScriptInterface::luaPlayerGetSkillPercent(lua_State* L) {
 	return 1;
 }
 
+int LuaScriptInterface::luaPlayerGetCustomAttribute(lua_State* L) {
+	// player:getCustomAttribute(id)
+	Player* player = lua::getUserdata<Player>(L, 1);
+	if (player) {
+		lua_pushnumber(L, player->getCustomAttribute(lua::getNumber<uint16_t>(L, 2)));
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaPlayerGetCustomSkill(lua_State* L) {
+	// player:getCustomSkill(skillId)
+	Player* player = lua::getUserdata<Player>(L, 1);
+	if (player) {
+		lua_pushnumber(L, player->getCustomSkill(lua::getNumber<uint16_t>(L, 2)));
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaPlayerSetCustomSkill(lua_State* L) {
+	// player:setCustomSkill(skillId, value)
+	Player* player = lua::getUserdata<Player>(L, 1);
+	uint16_t skillId = lua::getNumber<uint16_t>(L, 2);
+	if (player && skillId <= CUSTOMSKILL_LAST) {
+		player->setCustomSkill(skillId, lua::getNumber<int32_t>(L, 3));
+		lua::pushBoolean(L, true);
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaPlayerAddCustomSkill(lua_State* L) {
+	// player:addCustomSkill(skillId, amount)
+	Player* player = lua::getUserdata<Player>(L, 1);
+	uint16_t skillId = lua::getNumber<uint16_t>(L, 2);
+	if (player && skillId <= CUSTOMSKILL_LAST) {
+		int32_t value = player->getCustomSkill(skillId) + lua::getNumber<int32_t>(L, 3);
+		player->setCustomSkill(skillId, value);
+		lua_pushnumber(L, value);
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
 int LuaScriptInterface::luaPlayerGetSkillTries(lua_State* L) {
 	// player:getSkillTries(skillType)
 	skills_t skillType = lua::getNumber<skills_t>(L, 2);
@@ -10485,6 +10830,18 @@ int LuaScriptInterface::luaMonsterSetLevel(lua_State* L) {
         return 1;
 }
 
+int LuaScriptInterface::luaMonsterGetLoot(lua_State* L) {
+	// monster:getLoot()
+	Monster* monster = lua::getUserdata<Monster>(L, 1);
+	if (!monster) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	pushLoot(L, monster->mType->getLootItems(monster->getLevel()));
+	return 1;
+}
+
 int LuaScriptInterface::luaMonsterRename(lua_State* L) {
 	// monster:rename(name[, nameDescription])
 	Monster* monster = lua::getUserdata<Monster>(L, 1);
@@ -10724,7 +11081,8 @@ int LuaScriptInterface::luaMonsterGetTargetList(lua_State* L) {
 	lua_createtable(L, targetList.size(), 0);
 
 	int index = 0;
-	for (Creature* creature : targetList) {
+	for (const MonsterTarget& target : targetList) {
+		Creature* creature = target.creature;
 		lua::pushUserdata(L, creature);
 		lua::setCreatureMetatable(L, -1, creature);
 		lua_rawseti(L, -2, ++index);
@@ -292,6 +292,11 @@ class LuaScriptInterface {
 		static int luaGameGetMonsters(lua_State* L);
 
 		static int luaGameGetExperienceStage(lua_State* L);
+		static int luaGameGetCombatMessagesSaved(lua_State* L);
+		static int luaGameGetMonsterTargetChecksSaved(lua_State* L);
+		static int luaGameGetBroadcastEncodesSaved(lua_State* L);
+		static int luaGameGetScriptLookupsSkipped(lua_State* L);
+		static int luaGameGetLoginStats(lua_State* L);
 		static int luaGameGetExperienceForLevel(lua_State* L);
 		static int luaGameGetMonsterCount(lua_State* L);
 		static int luaGameGetPlayerCount(lua_State* L);
@@ -305,6 +310,8 @@ class LuaScriptInterface {
 
 		static int luaGameGetOutfits(lua_State* L);
 		static int luaGameGetMounts(lua_State* L);
+		static int luaGameGetCustomAttributes(lua_State* L);
+		static int luaGameGetCustomSkills(lua_State* L);
 
 		static int luaGameGetGameState(lua_State* L);
 		static int luaGameSetGameState(lua_State* L);
@@ -320,6 +327,9 @@ class LuaScriptInterface {
 		static int luaGameCreateMonster(lua_State* L);
 		static int luaGameCreateNpc(lua_State* L);
 		static int luaGameCreateTile(lua_State* L);
+		static int luaGameRegisterMapChunk(lua_State* L);
+		static int luaGameCreateMapChunk(lua_State* L);
+		static int luaGameRemoveMapChunk(lua_State* L);
 		static int luaGameCreateMonsterType(lua_State* L);
 
 		static int luaGameStartEvent(lua_State* L);
@@ -614,6 +624,8 @@ class LuaScriptInterface {
 
 		static int luaCreatureGetStorageValue(lua_State* L);
 		static int luaCreatureSetStorageValue(lua_State* L);
+		static int luaCreatureGetStorageValues(lua_State* L);
+		static int luaCreatureSetStorageValues(lua_State* L);
 
 		// Player
 		static int luaPlayerCreate(lua_State* L);
@@ -662,6 +674,10 @@ class LuaScriptInterface {
 		static int luaPlayerGetSkillLevel(lua_State* L);
 		static int luaPlayerGetEffectiveSkillLevel(lua_State* L);
 		static int luaPlayerGetSkillPercent(lua_State* L);
+		static int luaPlayerGetCustomAttribute(lua_State* L);
+		static int luaPlayerGetCustomSkill(lua_State* L);
+		static int luaPlayerSetCustomSkill(lua_State* L);
+		static int luaPlayerAddCustomSkill(lua_State* L);
 		static int luaPlayerGetSkillTries(lua_State* L);
 		static int luaPlayerAddSkillTries(lua_State* L);
 		static int luaPlayerRemoveSkillTries(lua_State* L);
@@ -816,6 +832,7 @@ class LuaScriptInterface {
 
                 static int luaMonsterGetLevel(lua_State* L);
                 static int luaMonsterSetLevel(lua_State* L);
+		static int luaMonsterGetLoot(lua_State* L);
 
 		static int luaMonsterRename(lua_State* L);
 
@@ -33,11 +33,17 @@ bool Map::loadMap(const std::string& identifier, bool loadHouses, bool isCalledB
 
 		IOMapSerialize::loadHouseInfo();
 		IOMapSerialize::loadHouseItems(this);
+
+		// the loaded house items match the database
+		for (const auto& it : houses.getHouses()) {
+			House* house = it.second;
+			house->setItemsSaved(house->getItemsVersion());
+		}
 	}
 	return true;
 }
 
-bool Map::save() {
+bool Map::save(std::function<void(bool)> callback/* = nullptr*/) {
 	bool saved = false;
 	for (uint32_t tries = 0; tries < 3; tries++) {
 		if (IOMapSerialize::saveHouseInfo()) {
@@ -50,14 +56,7 @@ bool Map::save() {
 		return false;
 	}
 
-	saved = false;
-	for (uint32_t tries = 0; tries < 3; tries++) {
-		if (IOMapSerialize::saveHouseItems()) {
-			saved = true;
-			break;
-		}
-	}
-	return saved;
+	return IOMapSerialize::saveHouseItems(std::move(callback));
 }
 
 Tile* Map::getTile(uint16_t x, uint16_t y, uint8_t z) const {
@@ -164,9 +163,10 @@ void Map::removeTile(uint16_t x, uint16_t y, uint8_t z) {
 			}
 		}
 
+		// removing an item erases it from the list, so walk it backwards
 		if (TileItemVector* items = tile->getItemList()) {
-			for (auto it = items->begin(), end = items->end(); it != end; ++it) {
-				g_game.internalRemoveItem(*it);
+			for (int32_t i = items->size(); --i >= 0;) {
+				g_game.internalRemoveItem(items->at(i));
 			}
 		}
 
@@ -245,7 +245,7 @@ bool Map::placeCreature(const Position& centerPos, Creature* creature, bool exte
 	toCylinder->internalAddThing(creature);
 
 	const Position& dest = toCylinder->getPosition();
-	getQTNode(dest.x, dest.y)->addCreature(creature);
+	creatureIndex.addCreature(creature, dest);
 	return true;
 }
 
@@ -281,14 +281,7 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 	//remove the creature
 	oldTile.removeThing(&creature, 0);
 
-	QTreeLeafNode* leaf = getQTNode(oldPos.x, oldPos.y);
-	QTreeLeafNode* new_leaf = getQTNode(newPos.x, newPos.y);
-
-	// Switch the node ownership
-	if (leaf != new_leaf) {
-		leaf->removeCreature(&creature);
-		new_leaf->addCreature(&creature);
-	}
+	creatureIndex.moveCreature(&creature, newPos);
 
 	//add the creature
 	newTile.addThing(&creature);
@@ -329,57 +322,12 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 }
 
 void Map::getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const {
-	auto min_y = centerPos.y + minRangeY;
-	auto min_x = centerPos.x + minRangeX;
-	auto max_y = centerPos.y + maxRangeY;
-	auto max_x = centerPos.x + maxRangeX;
-
-	int32_t minoffset = centerPos.getZ() - maxRangeZ;
-	uint16_t x1 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, (min_x + minoffset)));
-	uint16_t y1 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, (min_y + minoffset)));
-
-	int32_t maxoffset = centerPos.getZ() - minRangeZ;
-	uint16_t x2 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, (max_x + maxoffset)));
-	uint16_t y2 = std::min<uint32_t>(0xFFFF, std::max<int32_t>(0, (max_y + maxoffset)));
-
-	int32_t startx1 = x1 - (x1 % FLOOR_SIZE);
-	int32_t starty1 = y1 - (y1 % FLOOR_SIZE);
-	int32_t endx2 = x2 - (x2 % FLOOR_SIZE);
-	int32_t endy2 = y2 - (y2 % FLOOR_SIZE);
-
-	const QTreeLeafNode* startLeaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, starty1);
-	const QTreeLeafNode* leafS = startLeaf;
-	const QTreeLeafNode* leafE;
-
-	for (int_fast32_t ny = starty1; ny <= endy2; ny += FLOOR_SIZE) {
-		leafE = leafS;
-		for (int_fast32_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
-			if (leafE) {
-				const CreatureVector& node_list = (onlyPlayers ? leafE->player_list : leafE->creature_list);
-				for (Creature* creature : node_list) {
-					const Position& cpos = creature->getPosition();
-					if (minRangeZ > cpos.z || maxRangeZ < cpos.z) {
-						continue;
-					}
-
-					int16_t offsetZ = centerPos.getOffsetZ(cpos);
-					if ((min_y + offsetZ) > cpos.y || (max_y + offsetZ) < cpos.y || (min_x + offsetZ) > cpos.x || (max_x + offsetZ) < cpos.x) {
-						continue;
-					}
-
-					spectators.emplace_back(creature);
-				}
-				leafE = leafE->leafE;
-			} else {
-				leafE = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
-			}
-		}
-
-		if (leafS) {
-			leafS = leafS->leafS;
-		} else {
-			leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startx1, ny + FLOOR_SIZE);
-		}
+	const uint8_t types = onlyPlayers ? CREATUREINDEX_PLAYER : CREATUREINDEX_ALL;
+	for (int32_t z = std::max<int32_t>(0, minRangeZ), endZ = std::min<int32_t>(MAP_MAX_LAYERS - 1, maxRangeZ); z <= endZ; ++z) {
+		// other floors are seen shifted by their distance to the center floor
+		const int32_t offsetZ = centerPos.getZ() - z;
+		creatureIndex.getCreatures(spectators, centerPos.x + minRangeX + offsetZ, centerPos.y + minRangeY + offsetZ,
+		                           centerPos.x + maxRangeX + offsetZ, centerPos.y + maxRangeY + offsetZ, z, types);
 	}
 }
 
@@ -910,28 +858,6 @@ Floor* QTreeLeafNode::createFloor(uint32_t z) {
 	return array[z];
 }
 
-void QTreeLeafNode::addCreature(Creature* c) {
-	creature_list.push_back(c);
-
-	if (c->getPlayer()) {
-		player_list.push_back(c);
-	}
-}
-
-void QTreeLeafNode::removeCreature(Creature* c) {
-	auto iter = std::find(creature_list.begin(), creature_list.end(), c);
-	assert(iter != creature_list.end());
-	*iter = creature_list.back();
-	creature_list.pop_back();
-
-	if (c->getPlayer()) {
-		iter = std::find(player_list.begin(), player_list.end(), c);
-		assert(iter != player_list.end());
-		*iter = player_list.back();
-		player_list.pop_back();
-	}
-}
-
 uint32_t Map::clean() const {
 	uint64_t start = OTSYS_TIME();
 	size_t tiles = 0;
@@ -4,6 +4,7 @@
 #ifndef FS_MAP_H
 #define FS_MAP_H
 
+#include "creatureindex.h"
 #include "house.h"
 #include "position.h"
 #include "spawn.h"
@@ -122,16 +123,11 @@ class QTreeLeafNode final : public QTreeNode {
 			return array[z];
 		}
 
-		void addCreature(Creature* c);
-		void removeCreature(Creature* c);
-
 	private:
 		static bool newLeaf;
 		QTreeLeafNode* leafS = nullptr;
 		QTreeLeafNode* leafE = nullptr;
 		Floor* array[MAP_MAX_LAYERS] = {};
-		CreatureVector creature_list;
-		CreatureVector player_list;
 
 		friend class Map;
 		friend class QTreeNode;
@@ -159,9 +155,10 @@ class Map {
 
 		/**
 		  * Save a map.
-		  * \returns true if the map was saved successfully
+		  * \param callback receives the result of the house items write, which then runs on the database thread
+		  * \returns true if the map was saved successfully, or the house items write was queued
 		  */
-		static bool save();
+		static bool save(std::function<void(bool)> callback = nullptr);
 
 		/**
 		  * Get a single tile.
@@ -247,9 +244,74 @@ class Map {
 			return QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y);
 		}
 
+		/**
+		  * Visits the tiles of the rectangle [x, x + width) x [y, y + height) on floor z
+		  * one leaf at a time, following the leaf links instead of descending the tree
+		  * for every tile. Within a leaf the tiles are visited column by column.
+		  *	\param visitor called as visitor(tile, dx, dy) with the offset of the tile
+		  *	from (x, y), returning true stops the scan
+		  *	\return true if the visitor stopped the scan
+		  */
+		template<typename Visitor>
+		bool visitTiles(int32_t x, int32_t y, uint8_t z, int32_t width, int32_t height, Visitor&& visitor) const {
+			if (z >= MAP_MAX_LAYERS) {
+				return false;
+			}
+
+			const int32_t startX = std::max<int32_t>(0, x);
+			const int32_t startY = std::max<int32_t>(0, y);
+			const int32_t endX = std::min<int32_t>(0x10000, x + width);
+			const int32_t endY = std::min<int32_t>(0x10000, y + height);
+			if (startX >= endX || startY >= endY) {
+				return false;
+			}
+
+			const QTreeLeafNode* leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startX, startY);
+			for (int32_t ny = startY & ~FLOOR_MASK; ny < endY; ny += FLOOR_SIZE) {
+				const QTreeLeafNode* leafE = leafS;
+				for (int32_t nx = startX & ~FLOOR_MASK; nx < endX; nx += FLOOR_SIZE) {
+					if (!leafE) {
+						leafE = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, nx + FLOOR_SIZE, ny);
+						continue;
+					}
+
+					if (const Floor* floor = leafE->getFloor(z)) {
+						const int32_t fromY = std::max(ny, startY);
+						const int32_t toY = std::min(ny + FLOOR_SIZE, endY);
+						for (int32_t tx = std::max(nx, startX), toX = std::min(nx + FLOOR_SIZE, endX); tx < toX; ++tx) {
+							Tile* const* column = floor->tiles[tx & FLOOR_MASK];
+							for (int32_t ty = fromY; ty < toY; ++ty) {
+								if (Tile* tile = column[ty & FLOOR_MASK]; tile && visitor(tile, tx - x, ty - y)) {
+									return true;
+								}
+							}
+						}
+					}
+					leafE = leafE->leafE;
+				}
+
+				if (leafS) {
+					leafS = leafS->leafS;
+				} else {
+					leafS = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, startX, ny + FLOOR_SIZE);
+				}
+			}
+			return false;
+		}
+
+		// bumped whenever an item blocking projectiles is added to or removed from a
+		// tile, cached line of sight checks older than the current value are stale
+		uint32_t getSightVersion() const {
+			return sightVersion;
+		}
+		void onSightChanged() {
+			++sightVersion;
+		}
+
 		Spawns spawns;
 		Towns towns;
 		Houses houses;
+		CreatureIndex creatureIndex;
 
 	private:
 		SpectatorCache spectatorCache;
@@ -262,6 +324,7 @@ class Map {
 
 		uint32_t width = 0;
 		uint32_t height = 0;
+		uint32_t sightVersion = 0;
 
 		// Actually scans the map for spectators
 		void getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, int32_t minRangeZ, int32_t maxRangeZ, bool onlyPlayers) const;
@@ -0,0 +1,234 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#include "otpch.h"
+
+#include "mapchunks.h"
+
+#include "events.h"
+#include "game.h"
+#include "monster.h"
+
+extern Game g_game;
+
+namespace {
+
+Position rotateOffset(const Position& offset, size_t rotation, uint16_t sizeX, uint16_t sizeY) {
+	switch (rotation) {
+		case 1: return {static_cast<uint16_t>(sizeY - 1 - offset.y), offset.x, offset.z};
+		case 2: return {static_cast<uint16_t>(sizeX - 1 - offset.x), static_cast<uint16_t>(sizeY - 1 - offset.y), offset.z};
+		case 3: return {offset.y, static_cast<uint16_t>(sizeX - 1 - offset.x), offset.z};
+		default: return offset;
+	}
+}
+
+size_t getRotationIndex(uint16_t rotation) {
+	switch (rotation) {
+		case 90: return 1;
+		case 180: return 2;
+		case 270: return 3;
+		default: return 0;
+	}
+}
+
+Position getWorldPosition(const Position& basePos, const Position& offset) {
+	return {static_cast<uint16_t>(basePos.x + offset.x), static_cast<uint16_t>(basePos.y + offset.y), static_cast<uint8_t>(basePos.z + offset.z)};
+}
+
+Item* createChunkItem(const MapChunkItem& itemInfo) {
+	Item* item = Item::CreateItem(itemInfo.id, itemInfo.count);
+	if (!item) {
+		return nullptr;
+	}
+
+	if (itemInfo.actionId != 0) {
+		item->setActionId(itemInfo.actionId);
+	}
+
+	if (Container* container = item->getContainer()) {
+		for (const auto& [id, count] : itemInfo.contents) {
+			if (Item* content = Item::CreateItem(id, count)) {
+				container->internalAddThing(content);
+			}
+		}
+	}
+	return item;
+}
+
+}
+
+void MapChunks::addChunk(MapChunk chunk) {
+	for (size_t rotation = 0; rotation < chunk.layouts.size(); ++rotation) {
+		MapChunk::Layout& layout = chunk.layouts[rotation];
+		layout = {};
+
+		if (chunk.ground != 0) {
+			layout.ground.reserve(chunk.sizeX * chunk.sizeY);
+			for (uint16_t x = 0; x < chunk.sizeX; ++x) {
+				for (uint16_t y = 0; y < chunk.sizeY; ++y) {
+					layout.ground.push_back(rotateOffset(Position(x, y, 0), rotation, chunk.sizeX, chunk.sizeY));
+				}
+			}
+		}
+
+		layout.items.reserve(chunk.items.size());
+		for (const MapChunkItem& item : chunk.items) {
+			layout.items.push_back(rotateOffset(item.offset, rotation, chunk.sizeX, chunk.sizeY));
+		}
+
+		layout.monsters.reserve(chunk.monsters.size());
+		for (const MapChunkMonster& monster : chunk.monsters) {
+			layout.monsters.push_back(rotateOffset(monster.offset, rotation, chunk.sizeX, chunk.sizeY));
+		}
+
+		layout.effects.reserve(chunk.effects.size());
+		for (const MapChunkEffect& effect : chunk.effects) {
+			layout.effects.push_back(rotateOffset(effect.offset, rotation, chunk.sizeX, chunk.sizeY));
+		}
+	}
+
+	std::string name = chunk.name;
+	chunks.insert_or_assign(std::move(name), std::move(chunk));
+}
+
+const MapChunk* MapChunks::getChunk(std::string_view name) const {
+	auto it = chunks.find(name);
+	return it != chunks.end() ? &it->second : nullptr;
+}
+
+uint32_t MapChunks::createInstance(const MapChunk& chunk, const Position& basePos, uint16_t rotation) {
+	const MapChunk::Layout& layout = chunk.layouts[getRotationIndex(rotation)];
+	Instance instance;
+
+	// tiles that do not exist yet are built completely before they are linked
+	// into the map, so nobody is notified of every single item on them
+	std::vector<Tile*> newTiles;
+	for (const Position& offset : layout.ground) {
+		Item* ground = Item::CreateItem(chunk.ground);
+		if (!ground) {
+			break;
+		}
+
+		const Position pos = getWorldPosition(basePos, offset);
+		if (Tile* tile = g_game.map.getTile(pos)) {
+			if (g_game.internalAddItem(tile, ground, INDEX_WHEREEVER, FLAG_NOLIMIT) != RETURNVALUE_NOERROR) {
+				delete ground;
+				continue;
+			}
+
+			ground->incrementReferenceCounter();
+			instance.items.push_back(ground);
+			continue;
+		}
+
+		Tile* tile = new DynamicTile(pos.x, pos.y, pos.z);
+		tile->internalAddThing(ground);
+		ground->startDecaying();
+		g_game.map.setTile(pos, tile);
+
+		newTiles.push_back(tile);
+		instance.tiles.push_back(pos);
+	}
+
+	for (size_t i = 0, size = chunk.items.size(); i < size; ++i) {
+		const MapChunkItem& itemInfo = chunk.items[i];
+		const Position pos = getWorldPosition(basePos, layout.items[i]);
+
+		Tile* tile = g_game.map.getTile(pos);
+		if (!tile) {
+			continue;
+		}
+
+		Item* item = createChunkItem(itemInfo);
+		if (!item) {
+			continue;
+		}
+
+		if (std::find(newTiles.begin(), newTiles.end(), tile) != newTiles.end()) {
+			tile->internalAddThing(item);
+			item->startDecaying();
+		} else if (g_game.internalAddItem(tile, item, INDEX_WHEREEVER, FLAG_NOLIMIT) == RETURNVALUE_NOERROR) {
+			item->incrementReferenceCounter();
+			instance.items.push_back(item);
+		} else {
+			delete item;
+			continue;
+		}
+
+		if (itemInfo.effect != CONST_ME_NONE) {
+			g_game.addMagicEffect(pos, itemInfo.effect);
+		}
+	}
+
+	// send every new tile once to the players that see it
+	if (!newTiles.empty()) {
+		const bool rotated = (getRotationIndex(rotation) % 2) != 0;
+		const int32_t halfX = (rotated ? chunk.sizeY : chunk.sizeX) / 2;
+		const int32_t halfY = (rotated ? chunk.sizeX : chunk.sizeY) / 2;
+		const Position centerPos(basePos.x + halfX, basePos.y + halfY, basePos.z);
+
+		SpectatorVec spectators;
+		g_game.map.getSpectators(spectators, centerPos, true, true, halfX + Map::maxViewportX, halfX + Map::maxViewportX, halfY + Map::maxViewportY, halfY + Map::maxViewportY);
+		for (Creature* spectator : spectators) {
+			Player* player = spectator->getPlayer();
+			for (const Tile* tile : newTiles) {
+				if (player->canSee(tile->getPosition())) {
+					player->sendUpdateTile(tile, tile->getPosition());
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0, size = chunk.monsters.size(); i < size; ++i) {
+		const MapChunkMonster& monsterInfo = chunk.monsters[i];
+		Monster* monster = Monster::createMonster(monsterInfo.name);
+		if (!monster) {
+			continue;
+		}
+
+		const Position pos = getWorldPosition(basePos, layout.monsters[i]);
+		if (events::monster::onSpawn(monster, pos, false, true) && g_game.placeCreature(monster, pos, true, false, monsterInfo.effect)) {
+			instance.monsters.push_back(monster->getID());
+		} else {
+			delete monster;
+		}
+	}
+
+	for (size_t i = 0, size = chunk.effects.size(); i < size; ++i) {
+		g_game.addMagicEffect(getWorldPosition(basePos, layout.effects[i]), chunk.effects[i].effect);
+	}
+
+	const uint32_t instanceId = nextInstanceId++;
+	instances.emplace(instanceId, std::move(instance));
+	return instanceId;
+}
+
+bool MapChunks::removeInstance(uint32_t instanceId) {
+	auto it = instances.find(instanceId);
+	if (it == instances.end()) {
+		return false;
+	}
+
+	Instance& instance = it->second;
+	for (uint32_t monsterId : instance.monsters) {
+		if (Monster* monster = g_game.getMonsterByID(monsterId)) {
+			g_game.removeCreature(monster);
+		}
+	}
+
+	// items that were moved off their tile in the meantime belong to someone else now
+	for (Item* item : instance.items) {
+		Cylinder* parent = item->getParent();
+		if (parent && !item->isRemoved() && parent == parent->getTile()) {
+			g_game.internalRemoveItem(item);
+		}
+		item->decrementReferenceCounter();
+	}
+
+	for (const Position& pos : instance.tiles) {
+		g_game.map.removeTile(pos);
+	}
+
+	instances.erase(it);
+	return true;
+}
@@ -0,0 +1,81 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_MAPCHUNKS_H
+#define FS_MAPCHUNKS_H
+
+#include "const.h"
+#include "position.h"
+
+class Item;
+
+struct MapChunkItem {
+	Position offset;
+	uint16_t id = 0;
+	uint16_t count = 1;
+	uint16_t actionId = 0;
+	MagicEffectClasses effect = CONST_ME_NONE;
+	std::vector<std::pair<uint16_t, uint16_t>> contents;
+};
+
+struct MapChunkMonster {
+	Position offset;
+	std::string name;
+	MagicEffectClasses effect = CONST_ME_TELEPORT;
+};
+
+struct MapChunkEffect {
+	Position offset;
+	MagicEffectClasses effect = CONST_ME_NONE;
+};
+
+/**
+ * Template of a map chunk, e.g. a dungeon room that is stamped into the map
+ * on demand. The offsets of everything it holds are rotated once when the
+ * chunk is registered, one layout per rotation of 0, 90, 180 and 270 degrees.
+ */
+struct MapChunk {
+	struct Layout {
+		std::vector<Position> ground;
+		std::vector<Position> items;
+		std::vector<Position> monsters;
+		std::vector<Position> effects;
+	};
+
+	std::string name;
+	uint16_t sizeX = 1;
+	uint16_t sizeY = 1;
+	uint16_t ground = 0;
+
+	std::vector<MapChunkItem> items;
+	std::vector<MapChunkMonster> monsters;
+	std::vector<MapChunkEffect> effects;
+
+	std::array<Layout, 4> layouts;
+};
+
+class MapChunks {
+	public:
+		// compiles the rotated layouts, replaces a chunk with the same name
+		void addChunk(MapChunk chunk);
+		const MapChunk* getChunk(std::string_view name) const;
+
+		// returns the id of the new instance, rotation is given in degrees
+		uint32_t createInstance(const MapChunk& chunk, const Position& basePos, uint16_t rotation);
+		bool removeInstance(uint32_t instanceId);
+
+	private:
+		struct Instance {
+			// tiles the chunk created, they are cleared completely on removal
+			std::vector<Position> tiles;
+			// items placed on tiles that existed before
+			std::vector<Item*> items;
+			std::vector<uint32_t> monsters;
+		};
+
+		std::map<std::string, MapChunk, std::less<>> chunks;
+		std::unordered_map<uint32_t, Instance> instances;
+		uint32_t nextInstanceId = 1;
+};
+
+#endif // FS_MAPCHUNKS_H
@@ -19,6 +19,7 @@ int32_t Monster::despawnRange;
 int32_t Monster::despawnRadius;
 
 uint32_t Monster::monsterAutoID = 0x40000000;
+uint64_t Monster::targetChecksSaved = 0;
 
 Monster* Monster::createMonster(const std::string& name) {
 	MonsterType* mType = g_monsters.getMonsterType(name);
@@ -328,14 +329,14 @@ void Monster::onCreatureSay(Creature* creature, SpeakClasses type, const std::st
 
 void Monster::addFriend(Creature* creature) {
 	assert(creature != this);
-	auto result = friendList.insert(creature);
-	if (result.second) {
+	if (std::find(friendList.begin(), friendList.end(), creature) == friendList.end()) {
 		creature->incrementReferenceCounter();
+		friendList.push_back(creature);
 	}
 }
 
 void Monster::removeFriend(Creature* creature) {
-	auto it = friendList.find(creature);
+	auto it = std::find(friendList.begin(), friendList.end(), creature);
 	if (it != friendList.end()) {
 		creature->decrementReferenceCounter();
 		friendList.erase(it);
@@ -344,18 +345,18 @@ void Monster::removeFriend(Creature* creature) {
 
 void Monster::addTarget(Creature* creature, bool pushFront/* = false*/) {
 	assert(creature != this);
-	if (std::find(targetList.begin(), targetList.end(), creature) == targetList.end()) {
+	if (findTarget(creature) == targetList.end()) {
 		creature->incrementReferenceCounter();
 		if (pushFront) {
-			targetList.push_front(creature);
+			targetList.emplace(targetList.begin(), creature);
 		} else {
-			targetList.push_back(creature);
+			targetList.emplace_back(creature);
 		}
 	}
 }
 
 void Monster::removeTarget(Creature* creature) {
-	auto it = std::find(targetList.begin(), targetList.end(), creature);
+	auto it = findTarget(creature);
 	if (it != targetList.end()) {
 		creature->decrementReferenceCounter();
 		targetList.erase(it);
@@ -363,27 +364,21 @@ void Monster::removeTarget(Creature* creature) {
 }
 
 void Monster::updateTargetList() {
-	auto friendIterator = friendList.begin();
-	while (friendIterator != friendList.end()) {
-		Creature* creature = *friendIterator;
+	friendList.erase(std::remove_if(friendList.begin(), friendList.end(), [this](Creature* creature) {
 		if (creature->isDead() || !canSee(creature->getPosition())) {
 			creature->decrementReferenceCounter();
-			friendIterator = friendList.erase(friendIterator);
-		} else {
-			++friendIterator;
+			return true;
 		}
-	}
+		return false;
+	}), friendList.end());
 
-	auto targetIterator = targetList.begin();
-	while (targetIterator != targetList.end()) {
-		Creature* creature = *targetIterator;
-		if (creature->isDead() || !canSee(creature->getPosition())) {
-			creature->decrementReferenceCounter();
-			targetIterator = targetList.erase(targetIterator);
-		} else {
-			++targetIterator;
+	targetList.erase(std::remove_if(targetList.begin(), targetList.end(), [this](const MonsterTarget& target) {
+		if (target.creature->isDead() || !canSee(target.creature->getPosition())) {
+			target.creature->decrementReferenceCounter();
+			return true;
 		}
-	}
+		return false;
+	}), targetList.end());
 
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, position, true);
@@ -394,8 +389,8 @@ void Monster::updateTargetList() {
 }
 
 void Monster::clearTargetList() {
-	for (Creature* creature : targetList) {
-		creature->decrementReferenceCounter();
+	for (const MonsterTarget& target : targetList) {
+		target.creature->decrementReferenceCounter();
 	}
 	targetList.clear();
 }
@@ -506,12 +501,13 @@ void Monster::onCreatureLeave(Creature* creature) {
 }
 
 bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAULT*/) {
-	std::list<Creature*> resultList;
+	std::vector<Creature*> resultList;
 	const Position& myPos = getPosition();
 
-	for (Creature* creature : targetList) {
+	for (MonsterTarget& target : targetList) {
+		Creature* creature = target.creature;
 		if (followCreature != creature && isTarget(creature)) {
-			if (searchType == TARGETSEARCH_RANDOM || canUseAttack(myPos, creature)) {
+			if (searchType == TARGETSEARCH_RANDOM || canUseAttack(myPos, target)) {
 				resultList.push_back(creature);
 			}
 		}
@@ -538,7 +534,8 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 				}
 			} else {
 				int32_t minRange = std::numeric_limits<int32_t>::max();
-				for (Creature* creature : targetList) {
+				for (const MonsterTarget& entry : targetList) {
+					Creature* creature = entry.creature;
 					if (!isTarget(creature)) {
 						continue;
 					}
@@ -562,9 +559,7 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 		case TARGETSEARCH_RANDOM:
 		default: {
 			if (!resultList.empty()) {
-				auto it = resultList.begin();
-				std::advance(it, uniform_random(0, resultList.size() - 1));
-				return selectTarget(*it);
+				return selectTarget(resultList[uniform_random(0, resultList.size() - 1)]);
 			}
 
 			if (searchType == TARGETSEARCH_ATTACKRANGE) {
@@ -576,7 +571,8 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 	}
 
 	//lets just pick the first target in the list
-	for (Creature* target : targetList) {
+	for (size_t i = 0; i < targetList.size(); ++i) {
+		Creature* target = targetList[i].creature;
 		if (followCreature != target && selectTarget(target)) {
 			return true;
 		}
@@ -620,17 +616,17 @@ void Monster::goToFollowCreature() {
 }
 
 void Monster::onFollowCreatureComplete() {
-	auto it = std::find(targetList.begin(), targetList.end(), followCreature);
+	auto it = findTarget(followCreature);
 	if (it != targetList.end()) {
-		Creature* target = (*it);
+		MonsterTarget target = *it;
 		targetList.erase(it);
 
 		if (hasFollowPath) {
-			targetList.push_front(target);
+			targetList.insert(targetList.begin(), target);
 		} else if (!isSummon()) {
 			targetList.push_back(target);
 		} else {
-			target->decrementReferenceCounter();
+			target.creature->decrementReferenceCounter();
 		}
 	}
 }
@@ -675,8 +671,7 @@ bool Monster::selectTarget(Creature* creature) {
 		return false;
 	}
 
-	auto it = std::find(targetList.begin(), targetList.end(), creature);
-	if (it == targetList.end()) {
+	if (findTarget(creature) == targetList.end()) {
 		//Target not found in our target list.
 		return false;
 	}
@@ -725,7 +720,7 @@ void Monster::updateIdleStatus() {
 	if (!isSummon() && targetList.empty()) {
 		// check if there are aggressive conditions
 		idle = std::find_if(conditions.begin(), conditions.end(), [](Condition* condition) {
-			return condition->isAggressive();
+			return condition && condition->isAggressive();
 		}) == conditions.end();
 	}
 
@@ -897,6 +892,26 @@ bool Monster::canUseAttack(const Position& pos, const Creature* target) const {
 	return true;
 }
 
+bool Monster::canUseAttack(const Position& pos, MonsterTarget& target) {
+	// the attack range check is a line of sight test, only redo it once one of us moved,
+	// a projectile blocking item (a magic wall, a closed door) appeared or vanished anywhere,
+	// or the result got old enough for the monster type to have been reloaded
+	const Position& targetPos = target.creature->getPosition();
+	const uint32_t sightVersion = g_game.map.getSightVersion();
+	int64_t now = OTSYS_TIME();
+	if (target.checkedAt != 0 && target.checkedFrom == pos && target.checkedTo == targetPos && target.checkedSightVersion == sightVersion && now - target.checkedAt < EVENT_CREATURE_THINK_INTERVAL * 2) {
+		++targetChecksSaved;
+		return target.canAttack;
+	}
+
+	target.canAttack = canUseAttack(pos, target.creature);
+	target.checkedFrom = pos;
+	target.checkedTo = targetPos;
+	target.checkedAt = now;
+	target.checkedSightVersion = sightVersion;
+	return target.canAttack;
+}
+
 bool Monster::canUseSpell(const Position& pos, const Position& targetPos,
                          const spellBlock_t& sb, uint32_t interval, bool& inRange, bool& resetTicks) {
 	inRange = true;
@@ -1957,43 +1972,10 @@ void Monster::updateLookDirection() {
 	g_game.internalCreatureTurn(this, lookDirection);
 }
 
-namespace {
-       void applyBonusLoot(LootBlock& block, uint32_t level, float bonus)
-       {
-               if (bonus > 0.f && level > 1) {
-                       int extra = static_cast<int>(block.countmax * (level * bonus));
-                       if (extra > 0) {
-                               block.countmax += static_cast<uint32_t>(extra);
-                       }
-               }
-
-               for (LootBlock& child : block.childLoot) {
-                       applyBonusLoot(child, level, bonus);
-               }
-       }
-}
-
 void Monster::dropLoot(Container* corpse, Creature*) {
-        if (!corpse || !lootDrop) {
-                return;
-        }
-
-        std::vector<LootBlock> originalLoot;
-        if (ConfigManager::getBoolean(ConfigManager::MONSTER_LEVEL_SCALING)) {
-                float bonusLoot = ConfigManager::getFloat(ConfigManager::MONSTER_BONUS_LOOT);
-                if (bonusLoot > 0.f && level > 1) {
-                        originalLoot = mType->info.lootItems;
-                        for (LootBlock& block : mType->info.lootItems) {
-                                applyBonusLoot(block, level, bonusLoot);
-                        }
-                }
-        }
-
-        events::monster::onDropLoot(this, corpse);
-
-        if (!originalLoot.empty()) {
-                mType->info.lootItems = std::move(originalLoot);
-        }
+	if (corpse && lootDrop) {
+		events::monster::onDropLoot(this, corpse);
+	}
 }
 
 void Monster::setNormalCreatureLight() {
@@ -13,8 +13,21 @@ class Item;
 class Spawn;
 class Tile;
 
-using CreatureHashSet = std::unordered_set<Creature*>;
-using CreatureList = std::list<Creature*>;
+// a monster target and the cached result of the last attack range check against it,
+// reused while neither the monster nor the target moved
+struct MonsterTarget {
+	explicit MonsterTarget(Creature* creature) : creature(creature) {}
+
+	Creature* creature;
+	Position checkedFrom;
+	Position checkedTo;
+	int64_t checkedAt = 0;
+	uint32_t checkedSightVersion = 0;
+	bool canAttack = false;
+};
+
+using MonsterFriendList = std::vector<Creature*>;
+using MonsterTargetList = std::vector<MonsterTarget>;
 
 enum TargetSearchType_t {
 	TARGETSEARCH_DEFAULT,
@@ -151,10 +164,10 @@ class Monster final : public Creature {
 		bool searchTarget(TargetSearchType_t searchType = TARGETSEARCH_DEFAULT);
 		bool selectTarget(Creature* creature);
 
-		const CreatureList& getTargetList() const {
+		const MonsterTargetList& getTargetList() const {
 			return targetList;
 		}
-		const CreatureHashSet& getFriendList() const {
+		const MonsterFriendList& getFriendList() const {
 			return friendList;
 		}
 
@@ -175,12 +188,13 @@ class Monster final : public Creature {
 		                     bool checkDefense = false, bool checkArmor = false, bool field = false, bool ignoreResistances = false) override;
 
 		static uint32_t monsterAutoID;
+		static uint64_t targetChecksSaved;
 
 		using Creature::onWalk;
 
 	private:
-		CreatureHashSet friendList;
-		CreatureList targetList;
+		MonsterFriendList friendList;
+		MonsterTargetList targetList;
 
                 std::string name;
                 std::string nameDescription;
@@ -238,6 +252,12 @@ class Monster final : public Creature {
 		void onEndCondition(ConditionType_t type) override;
 
 		bool canUseAttack(const Position& pos, const Creature* target) const;
+		bool canUseAttack(const Position& pos, MonsterTarget& target);
+		MonsterTargetList::iterator findTarget(const Creature* creature) {
+			return std::find_if(targetList.begin(), targetList.end(), [creature](const MonsterTarget& target) {
+				return target.creature == creature;
+			});
+		}
 		bool canUseSpell(const Position& pos, const Position& targetPos,
 		                 const spellBlock_t& sb, uint32_t interval, bool& inRange, bool& resetTicks);
 		bool getRandomStep(const Position& creaturePos, Direction& direction) const;
@@ -35,6 +35,56 @@ void MonsterType::loadLoot(MonsterType* monsterType, LootBlock lootBlock) {
 	} else {
 		monsterType->info.lootItems.push_back(lootBlock);
 	}
+	monsterType->info.scaledLootItems.clear();
+}
+
+void MonsterType::clearLoot() {
+	info.lootItems.clear();
+	info.scaledLootItems.clear();
+}
+
+namespace {
+
+void applyBonusLoot(LootBlock& block, uint32_t level, float bonus) {
+	int32_t extra = static_cast<int32_t>(block.countmax * (level * bonus));
+	if (extra > 0) {
+		block.countmax += static_cast<uint32_t>(extra);
+	}
+
+	for (LootBlock& child : block.childLoot) {
+		applyBonusLoot(child, level, bonus);
+	}
+}
+
+}
+
+const std::vector<LootBlock>& MonsterType::getLootItems(uint32_t level) {
+	if (level <= 1 || !ConfigManager::getBoolean(ConfigManager::MONSTER_LEVEL_SCALING)) {
+		return info.lootItems;
+	}
+
+	float bonus = ConfigManager::getFloat(ConfigManager::MONSTER_BONUS_LOOT);
+	if (bonus <= 0.f) {
+		return info.lootItems;
+	}
+
+	// config reload may change the bonus, drop tables built with the old one
+	if (bonus != info.scaledLootBonus) {
+		info.scaledLootItems.clear();
+		info.scaledLootBonus = bonus;
+	}
+
+	auto it = info.scaledLootItems.find(level);
+	if (it != info.scaledLootItems.end()) {
+		return it->second;
+	}
+
+	std::vector<LootBlock>& lootItems = info.scaledLootItems[level];
+	lootItems = info.lootItems;
+	for (LootBlock& block : lootItems) {
+		applyBonusLoot(block, level, bonus);
+	}
+	return lootItems;
 }
 
 bool Monsters::loadFromXml(bool reloading /*= false*/) {
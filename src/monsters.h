@@ -96,6 +96,9 @@ class MonsterType {
 		std::vector<voiceBlock_t> voiceVector;
 
 		std::vector<LootBlock> lootItems;
+		// level-scaled copies of lootItems, built on first use per monster level
+		std::map<uint32_t, std::vector<LootBlock>> scaledLootItems;
+		float scaledLootBonus = 0.f;
 		std::vector<std::string> scripts;
 		std::vector<spellBlock_t> attackSpells;
 		std::vector<spellBlock_t> defenseSpells;
@@ -167,6 +170,8 @@ class MonsterType {
 		MonsterInfo info;
 
 		void loadLoot(MonsterType* monsterType, LootBlock lootBlock);
+		void clearLoot();
+		const std::vector<LootBlock>& getLootItems(uint32_t level);
 };
 
 class MonsterSpell {
@@ -12,6 +12,33 @@
 extern Game g_game;
 extern Vocations g_vocations;
 
+namespace {
+
+uint8_t getEventTypes(const MoveEventList& eventList) {
+	uint8_t eventTypes = 0;
+	for (int eventType = MOVE_EVENT_STEP_IN; eventType < MOVE_EVENT_LAST; ++eventType) {
+		if (!eventList.moveEvent[eventType].empty()) {
+			eventTypes |= 1 << eventType;
+		}
+	}
+	return eventTypes;
+}
+
+MoveEvent* getFirstEvent(const std::unordered_map<int32_t, MoveEventList*>& lookup, int32_t id, MoveEvent_t eventType) {
+	auto it = lookup.find(id);
+	if (it == lookup.end()) {
+		return nullptr;
+	}
+
+	std::list<MoveEvent>& moveEventList = it->second->moveEvent[eventType];
+	if (moveEventList.empty()) {
+		return nullptr;
+	}
+	return &moveEventList.front();
+}
+
+}
+
 MoveEvents::MoveEvents() :
 	scriptInterface("MoveEvents Interface") {
 	scriptInterface.initState();
@@ -56,6 +83,7 @@ void MoveEvents::clear(bool fromLua) {
 	clearMap(actionIdMap, fromLua);
 	clearMap(uniqueIdMap, fromLua);
 	clearPosMap(positionMap, fromLua);
+	lookupChanged = true;
 
 	reInitState(fromLua);
 }
@@ -265,6 +293,8 @@ bool MoveEvents::registerLuaEvent(MoveEvent* event) {
 }
 
 void MoveEvents::addEvent(MoveEvent moveEvent, int32_t id, MoveListMap& map) {
+	lookupChanged = true;
+
 	auto it = map.find(id);
 	if (it == map.end()) {
 		MoveEventList moveEventList;
@@ -297,52 +327,91 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 		default: slotp = 0; break;
 	}
 
-	auto it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-		for (MoveEvent& moveEvent : moveEventList) {
-			if ((moveEvent.getSlot() & slotp) != 0) {
-				return &moveEvent;
-			}
+	updateLookup();
+
+	const uint16_t itemId = item->getID();
+	if (itemId >= itemIdLookup.size() || (itemIdLookup[itemId].eventTypes & (1 << eventType)) == 0) {
+		++lookupsSkipped;
+		return nullptr;
+	}
+
+	for (MoveEvent& moveEvent : itemIdLookup[itemId].events->moveEvent[eventType]) {
+		if ((moveEvent.getSlot() & slotp) != 0) {
+			return &moveEvent;
 		}
 	}
 	return nullptr;
 }
 
 MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType) {
-	MoveListMap::iterator it;
+	updateLookup();
 
+	const uint8_t eventMask = 1 << eventType;
 	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID)) {
-		it = uniqueIdMap.find(item->getUniqueId());
-		if (it != uniqueIdMap.end()) {
-			std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-			if (!moveEventList.empty()) {
-				return &(*moveEventList.begin());
-			}
+		if ((uniqueIdEventTypes & eventMask) == 0) {
+			++lookupsSkipped;
+		} else if (MoveEvent* moveEvent = getFirstEvent(uniqueIdLookup, item->getUniqueId(), eventType)) {
+			return moveEvent;
 		}
 	}
 
 	if (item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
-		it = actionIdMap.find(item->getActionId());
-		if (it != actionIdMap.end()) {
-			std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-			if (!moveEventList.empty()) {
-				return &(*moveEventList.begin());
-			}
+		if ((actionIdEventTypes & eventMask) == 0) {
+			++lookupsSkipped;
+		} else if (MoveEvent* moveEvent = getFirstEvent(actionIdLookup, item->getActionId(), eventType)) {
+			return moveEvent;
 		}
 	}
 
-	it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-		if (!moveEventList.empty()) {
-			return &(*moveEventList.begin());
+	const uint16_t itemId = item->getID();
+	if (itemId >= itemIdLookup.size() || (itemIdLookup[itemId].eventTypes & eventMask) == 0) {
+		++lookupsSkipped;
+		return nullptr;
+	}
+	return &itemIdLookup[itemId].events->moveEvent[eventType].front();
+}
+
+void MoveEvents::updateLookup() {
+	if (!lookupChanged) {
+		return;
+	}
+
+	lookupChanged = false;
+
+	itemIdLookup.clear();
+	if (!itemIdMap.empty()) {
+		itemIdLookup.resize(std::max<int32_t>(itemIdMap.rbegin()->first + 1, 0));
+	}
+
+	for (auto& [id, eventList] : itemIdMap) {
+		if (id >= 0) {
+			itemIdLookup[id] = {&eventList, getEventTypes(eventList)};
 		}
 	}
-	return nullptr;
+
+	auto compileIds = [](MoveListMap& map, std::unordered_map<int32_t, MoveEventList*>& lookup, uint8_t& eventTypes) {
+		lookup.clear();
+		eventTypes = 0;
+		for (auto& [id, eventList] : map) {
+			if (uint8_t types = getEventTypes(eventList)) {
+				lookup.emplace(id, &eventList);
+				eventTypes |= types;
+			}
+		}
+	};
+
+	compileIds(uniqueIdMap, uniqueIdLookup, uniqueIdEventTypes);
+	compileIds(actionIdMap, actionIdLookup, actionIdEventTypes);
+
+	positionEventTypes = 0;
+	for (const auto& it : positionMap) {
+		positionEventTypes |= getEventTypes(it.second);
+	}
 }
 
 void MoveEvents::addEvent(MoveEvent moveEvent, const Position& pos, MovePosListMap& map) {
+	lookupChanged = true;
+
 	auto it = map.find(pos);
 	if (it == map.end()) {
 		MoveEventList moveEventList;
@@ -359,6 +428,13 @@ void MoveEvents::addEvent(MoveEvent moveEvent, const Position& pos, MovePosListM
 }
 
 MoveEvent* MoveEvents::getEvent(const Tile* tile, MoveEvent_t eventType) {
+	updateLookup();
+
+	if ((positionEventTypes & (1 << eventType)) == 0) {
+		++lookupsSkipped;
+		return nullptr;
+	}
+
 	auto it = positionMap.find(tile->getPosition());
 	if (it != positionMap.end()) {
 		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
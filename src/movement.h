@@ -49,6 +49,10 @@ class MoveEvents final : public BaseEvents {
 
 		MoveEvent* getEvent(Item* item, MoveEvent_t eventType);
 
+		uint64_t getLookupsSkipped() const {
+			return lookupsSkipped;
+		}
+
 		bool registerLuaEvent(MoveEvent* event);
 		bool registerLuaFunction(MoveEvent* event);
 		void clear(bool fromLua) override final;
@@ -120,11 +124,29 @@ class MoveEvents final : public BaseEvents {
 
 		MoveEvent* getEvent(Item* item, MoveEvent_t eventType, slots_t slot);
 
+		// compiles the maps below into the lookup tables on the first lookup after a change
+		void updateLookup();
+
 		MoveListMap uniqueIdMap;
 		MoveListMap actionIdMap;
 		MoveListMap itemIdMap;
 		MovePosListMap positionMap;
 
+		// event lists indexed by item id along with a bit per registered event type, most items have none
+		struct ItemIdLookup {
+			MoveEventList* events = nullptr;
+			uint8_t eventTypes = 0;
+		};
+
+		std::vector<ItemIdLookup> itemIdLookup;
+		std::unordered_map<int32_t, MoveEventList*> uniqueIdLookup;
+		std::unordered_map<int32_t, MoveEventList*> actionIdLookup;
+		uint8_t uniqueIdEventTypes = 0;
+		uint8_t actionIdEventTypes = 0;
+		uint8_t positionEventTypes = 0;
+		bool lookupChanged = true;
+		uint64_t lookupsSkipped = 0;
+
 		std::map<MoveEvent*, std::vector<uint32_t>> itemIdRange;
 		std::map<MoveEvent*, std::vector<uint32_t>> actionIdRange;
 		std::map<MoveEvent*, std::vector<uint32_t>> uniqueIdRange;
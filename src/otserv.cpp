@@ -139,6 +139,18 @@ namespace {
 			return;
 		}
 
+		std::cout << ">> Loading custom attributes" << std::endl;
+		if (!g_game.customAttributes.loadFromXml()) {
+			startupErrorMessage("Unable to load custom attributes!");
+			return;
+		}
+
+		std::cout << ">> Loading custom skills" << std::endl;
+		if (!g_game.customSkills.loadFromXml()) {
+			startupErrorMessage("Unable to load custom skills!");
+			return;
+		}
+
 		// load item data
 		std::cout << ">> Loading items... ";
 		if (!Item::items.loadFromOtb("data/items/items.otb")) {
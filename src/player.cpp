@@ -376,7 +376,7 @@ float Player::getDefenseFactor() const {
 uint16_t Player::getClientIcons() const {
 	uint16_t icons = 0;
 	for (Condition* condition : conditions) {
-		if (!isSuppress(condition->getType())) {
+		if (condition && !isSuppress(condition->getType())) {
 			icons |= condition->getIcons();
 		}
 	}
@@ -637,6 +637,42 @@ void Player::setStorageValue(uint32_t key, std::optional<int32_t> value, bool is
 	}
 
 	Creature::setStorageValue(key, value, isSpawn);
+	if (!isSpawn) {
+		storageChanges.insert(key);
+	}
+
+	if (key > CUSTOMATTRIBUTE_STORAGE_BASE && key <= CUSTOMATTRIBUTE_STORAGE_BASE + CUSTOMATTRIBUTE_LAST) {
+		customAttributes[key - CUSTOMATTRIBUTE_STORAGE_BASE] = value.value_or(0);
+	}
+}
+
+bool Player::rollCustomAttribute(CustomAttributeId_t id) const {
+	const int32_t chance = getCustomAttribute(id);
+	return chance > 0 && uniform_random(1, 100) <= chance;
+}
+
+void Player::updateEquipmentAttributes() {
+	equipmentAttributes.fill(0);
+
+	for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+		Item* item = inventory[slot];
+		if (!item || !item->hasAttribute(ITEM_ATTRIBUTE_CUSTOM)) {
+			continue;
+		}
+
+		for (const CustomAttribute& attribute : g_game.customAttributes.getAttributes()) {
+			const ItemAttributes::CustomAttribute* value = item->getCustomAttribute(attribute.id);
+			if (!value) {
+				continue;
+			}
+
+			if (const int64_t* intValue = boost::get<int64_t>(&value->value)) {
+				equipmentAttributes[attribute.id] += *intValue;
+			} else if (const double* doubleValue = boost::get<double>(&value->value)) {
+				equipmentAttributes[attribute.id] += *doubleValue;
+			}
+		}
+	}
 }
 
 bool Player::canSee(const Position& pos) const {
@@ -722,19 +758,10 @@ void Player::onReceiveMail() const {
 
 bool Player::isNearDepotBox() const {
 	const Position& pos = getPosition();
-	for (int32_t cx = -NOTIFY_DEPOT_BOX_RANGE; cx <= NOTIFY_DEPOT_BOX_RANGE; ++cx) {
-		for (int32_t cy = -NOTIFY_DEPOT_BOX_RANGE; cy <= NOTIFY_DEPOT_BOX_RANGE; ++cy) {
-			Tile* tile = g_game.map.getTile(pos.x + cx, pos.y + cy, pos.z);
-			if (!tile) {
-				continue;
-			}
-
-			if (tile->hasFlag(TILESTATE_DEPOT)) {
-				return true;
-			}
-		}
-	}
-	return false;
+	const int32_t size = NOTIFY_DEPOT_BOX_RANGE * 2 + 1;
+	return g_game.map.visitTiles(pos.x - NOTIFY_DEPOT_BOX_RANGE, pos.y - NOTIFY_DEPOT_BOX_RANGE, pos.z, size, size, [](const Tile* tile, int32_t, int32_t) {
+		return tile->hasFlag(TILESTATE_DEPOT);
+	});
 }
 
 DepotChest_ptr Player::getDepotChest(uint32_t depotId, bool autoCreate) {
@@ -1420,7 +1447,7 @@ uint32_t Player::isMuted() const {
 
 	int32_t muteTicks = 0;
 	for (Condition* condition : conditions) {
-		if (condition->getType() == CONDITION_MUTED && condition->getTicks() > muteTicks) {
+		if (condition && condition->getType() == CONDITION_MUTED && condition->getTicks() > muteTicks) {
 			muteTicks = condition->getTicks();
 		}
 	}
@@ -1976,35 +2003,11 @@ void Player::death(Creature* lastHitCreature) {
 			mana = manaMax;
 		}
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			Condition* condition = *it;
-			if (condition->isPersistent()) {
-				it = conditions.erase(it);
-
-				condition->endCondition(this);
-				onEndCondition(condition->getType());
-				delete condition;
-			} else {
-				++it;
-			}
-		}
+		removePersistentConditions();
 	} else {
 		setSkillLoss(true);
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			Condition* condition = *it;
-			if (condition->isPersistent()) {
-				it = conditions.erase(it);
-
-				condition->endCondition(this);
-				onEndCondition(condition->getType());
-				delete condition;
-			} else {
-				++it;
-			}
-		}
+		removePersistentConditions();
 
 		health = healthMax;
 		g_game.internalTeleport(this, getTemplePosition(), true);
@@ -2431,23 +2434,19 @@ ReturnValue Player::queryMaxCount(int32_t index, const Thing& thing, uint32_t co
 
 	if (index == INDEX_WHEREEVER) {
 		uint32_t n = 0;
+
+		//all containers in the inventory, including sub-containers (deep search)
+		updateInventoryIndex();
+		for (const Container* container : inventoryContainers) {
+			uint32_t queryCount = 0;
+			container->queryMaxCount(INDEX_WHEREEVER, *item, item->getItemCount(), queryCount, flags);
+			n += queryCount;
+		}
+
 		for (int32_t slotIndex = CONST_SLOT_FIRST; slotIndex <= CONST_SLOT_LAST; ++slotIndex) {
 			Item* inventoryItem = inventory[slotIndex];
 			if (inventoryItem) {
-				if (Container* subContainer = inventoryItem->getContainer()) {
-					uint32_t queryCount = 0;
-					subContainer->queryMaxCount(INDEX_WHEREEVER, *item, item->getItemCount(), queryCount, flags);
-					n += queryCount;
-
-					//iterate through all items, including sub-containers (deep search)
-					for (ContainerIterator it = subContainer->iterator(); it.hasNext(); it.advance()) {
-						if (Container* tmpContainer = (*it)->getContainer()) {
-							queryCount = 0;
-							tmpContainer->queryMaxCount(INDEX_WHEREEVER, *item, item->getItemCount(), queryCount, flags);
-							n += queryCount;
-						}
-					}
-				} else if (inventoryItem->isStackable() && item->equals(inventoryItem) && inventoryItem->getItemCount() < ITEM_STACK_SIZE) {
+				if (!inventoryItem->getContainer() && inventoryItem->isStackable() && item->equals(inventoryItem) && inventoryItem->getItemCount() < ITEM_STACK_SIZE) {
 					uint32_t remainder = (100 - inventoryItem->getItemCount());
 
 					if (queryAdd(slotIndex, *item, remainder, flags) == RETURNVALUE_NOERROR) {
@@ -2767,24 +2766,21 @@ size_t Player::getLastIndex() const {
 }
 
 uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) const {
-	uint32_t count = 0;
-	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
-		Item* item = inventory[i];
-		if (!item) {
-			continue;
-		}
+	updateInventoryIndex();
 
-		if (item->getID() == itemId) {
-			count += Item::countByType(item, subType);
-		}
+	auto it = inventoryIndex.find(itemId);
+	if (it == inventoryIndex.end()) {
+		return 0;
+	}
 
-		if (Container* container = item->getContainer()) {
-			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				if ((*it)->getID() == itemId) {
-					count += Item::countByType(*it, subType);
-				}
-			}
-		}
+	const InventoryIndexEntry& entry = it->second;
+	if (subType == -1) {
+		return entry.count;
+	}
+
+	uint32_t count = 0;
+	for (const Item* item : entry.items) {
+		count += Item::countByType(item, subType);
 	}
 	return count;
 }
@@ -2794,6 +2790,11 @@ bool Player::removeItemOfType(uint16_t itemId, uint32_t amount, int32_t subType,
 		return true;
 	}
 
+	// the walk below can never find more than the index holds
+	if (getItemTypeCount(itemId, subType) < amount) {
+		return false;
+	}
+
 	std::vector<Item*> itemList;
 
 	uint32_t count = 0;
@@ -2817,22 +2818,26 @@ bool Player::removeItemOfType(uint16_t itemId, uint32_t amount, int32_t subType,
 				return true;
 			}
 		} else if (Container* container = item->getContainer()) {
-			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				Item* containerItem = *it;
-				if (containerItem->getID() == itemId) {
-					uint32_t itemCount = Item::countByType(containerItem, subType);
-					if (itemCount == 0) {
-						continue;
-					}
-
-					itemList.push_back(containerItem);
+			// items closer to the top of the backpack are taken first
+			const bool found = container->visitItemsByLevel([&](Item* containerItem) {
+				if (containerItem->getID() != itemId) {
+					return false;
+				}
 
-					count += itemCount;
-					if (count >= amount) {
-						g_game.internalRemoveItems(std::move(itemList), amount, Item::items[itemId].stackable);
-						return true;
-					}
+				uint32_t itemCount = Item::countByType(containerItem, subType);
+				if (itemCount == 0) {
+					return false;
 				}
+
+				itemList.push_back(containerItem);
+
+				count += itemCount;
+				return count >= amount;
+			});
+
+			if (found) {
+				g_game.internalRemoveItems(std::move(itemList), amount, Item::items[itemId].stackable);
+				return true;
 			}
 		}
 	}
@@ -2840,22 +2845,81 @@ bool Player::removeItemOfType(uint16_t itemId, uint32_t amount, int32_t subType,
 }
 
 std::map<uint32_t, uint32_t>& Player::getAllItemTypeCount(std::map<uint32_t, uint32_t>& countMap) const {
+	updateInventoryIndex();
+
+	for (const auto& [itemId, entry] : inventoryIndex) {
+		countMap[itemId] += entry.count;
+	}
+	return countMap;
+}
+
+void Player::updateInventoryIndex() const {
+	if (!inventoryIndexChanged) {
+#ifndef NDEBUG
+		checkInventoryIndex();
+#endif
+		return;
+	}
+
+	for (auto& it : inventoryIndex) {
+		it.second.count = 0;
+		it.second.items.clear();
+	}
+	inventoryContainers.clear();
+
+	const auto addItem = [this](Item* item) {
+		InventoryIndexEntry& entry = inventoryIndex[item->getID()];
+		entry.count += item->getItemCount();
+		entry.items.push_back(item);
+
+		if (Container* container = item->getContainer()) {
+			inventoryContainers.push_back(container);
+		}
+	};
+
 	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
 		Item* item = inventory[i];
 		if (!item) {
 			continue;
 		}
 
-		countMap[item->getID()] += Item::countByType(item, -1);
+		addItem(item);
+		if (Container* container = item->getContainer()) {
+			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+				addItem(*it);
+			}
+		}
+	}
+
+	std::erase_if(inventoryIndex, [](const auto& it) { return it.second.items.empty(); });
+	inventoryIndexChanged = false;
+}
 
+#ifndef NDEBUG
+void Player::checkInventoryIndex() const {
+	// a change that did not reach the post notifications leaves the index stale
+	std::map<uint16_t, uint32_t> countMap;
+	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
+		Item* item = inventory[i];
+		if (!item) {
+			continue;
+		}
+
+		countMap[item->getID()] += item->getItemCount();
 		if (Container* container = item->getContainer()) {
 			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
-				countMap[(*it)->getID()] += Item::countByType(*it, -1);
+				countMap[(*it)->getID()] += (*it)->getItemCount();
 			}
 		}
 	}
-	return countMap;
+
+	assert(countMap.size() == inventoryIndex.size());
+	for (const auto& [itemId, count] : countMap) {
+		auto it = inventoryIndex.find(itemId);
+		assert(it != inventoryIndex.end() && it->second.count == count);
+	}
 }
+#endif
 
 Thing* Player::getThing(size_t index) const {
 	if (index >= CONST_SLOT_FIRST && index <= CONST_SLOT_LAST) {
@@ -2865,9 +2929,14 @@ Thing* Player::getThing(size_t index) const {
 }
 
 void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_t index, cylinderlink_t link /*= LINK_OWNER*/) {
+	if (link == LINK_OWNER || link == LINK_TOPPARENT) {
+		inventoryIndexChanged = true;
+	}
+
 	if (link == LINK_OWNER) {
 		//calling movement scripts
 		g_moveEvents->onPlayerEquip(this, thing->getItem(), static_cast<slots_t>(index), false);
+		updateEquipmentAttributes();
 		events::player::onInventoryUpdate(this, thing->getItem(), static_cast<slots_t>(index), true);
 	}
 
@@ -2919,9 +2988,14 @@ void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_
 }
 
 void Player::postRemoveNotification(Thing* thing, const Cylinder* newParent, int32_t index, cylinderlink_t link /*= LINK_OWNER*/) {
+	if (link == LINK_OWNER || link == LINK_TOPPARENT) {
+		inventoryIndexChanged = true;
+	}
+
 	if (link == LINK_OWNER) {
 		//calling movement scripts
 		g_moveEvents->onPlayerDeEquip(this, thing->getItem(), static_cast<slots_t>(index));
+		updateEquipmentAttributes();
 		events::player::onInventoryUpdate(this, thing->getItem(), static_cast<slots_t>(index), false);
 	}
 
@@ -3040,6 +3114,7 @@ void Player::internalAddThing(uint32_t index, Thing* thing) {
 
 		inventory[index] = item;
 		item->setParent(this);
+		inventoryIndexChanged = true;
 	}
 }
 
@@ -4352,7 +4427,7 @@ size_t Player::getMaxDepotItems() const {
 std::forward_list<Condition*> Player::getMuteConditions() const {
 	std::forward_list<Condition*> muteConditions;
 	for (Condition* condition : conditions) {
-		if (condition->getTicks() <= 0) {
+		if (!condition || condition->getTicks() <= 0) {
 			continue;
 		}
 
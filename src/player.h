@@ -5,6 +5,8 @@
 #define FS_PLAYER_H
 
 #include "creature.h"
+#include "customattributes.h"
+#include "customskills.h"
 #include "cylinder.h"
 #include "depotchest.h"
 #include "depotlocker.h"
@@ -602,6 +604,32 @@ class Player final : public Creature, public Cylinder {
 			return skills[skill].percent;
 		}
 
+		// base value given by scripts plus the values of the equipped items
+		int32_t getCustomAttribute(uint16_t id) const {
+			if (id > CUSTOMATTRIBUTE_LAST) {
+				return 0;
+			}
+			return customAttributes[id] + equipmentAttributes[id];
+		}
+		// rolls a chance attribute, its value is the chance in percent
+		bool rollCustomAttribute(CustomAttributeId_t id) const;
+		// sums up the custom attributes of the items in the inventory slots
+		void updateEquipmentAttributes();
+
+		int32_t getCustomSkill(uint16_t id) const {
+			if (id > CUSTOMSKILL_LAST) {
+				return 0;
+			}
+			return customSkills[id];
+		}
+		void setCustomSkill(uint16_t id, int32_t value) {
+			if (id > CUSTOMSKILL_LAST || customSkills[id] == value) {
+				return;
+			}
+			customSkills[id] = value;
+			customSkillChanges.set(id);
+		}
+
 		bool getAddAttackSkill() const {
 			return addAttackSkillPoint;
 		}
@@ -1079,7 +1107,7 @@ class Player final : public Creature, public Cylinder {
 			}
 		}
 
-		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers) {
+		void sendChannel(uint16_t channelId, const std::string& channelName, const UserList* channelUsers, const InvitedMap* invitedUsers) {
 			if (client) {
 				client->sendChannel(channelId, channelName, channelUsers, invitedUsers);
 			}
@@ -1114,7 +1142,7 @@ class Player final : public Creature, public Cylinder {
 				client->sendFightModes();
 			}
 		}
-		void sendNetworkMessage(const NetworkMessage& message) {
+		void sendNetworkMessage(const NetworkMessage& message) const {
 			if (client) {
 				client->writeToOutputBuffer(message);
 			}
@@ -1222,6 +1250,26 @@ class Player final : public Creature, public Cylinder {
 
 		std::unordered_set<uint32_t> attackedSet;
 		std::unordered_set<uint32_t> VIPList;
+		// storage keys set or removed since the last save
+		std::unordered_set<uint32_t> storageChanges;
+
+		std::array<int32_t, CUSTOMATTRIBUTE_LAST + 1> customAttributes = {};
+		std::array<int32_t, CUSTOMATTRIBUTE_LAST + 1> equipmentAttributes = {};
+
+		// custom skill values and the skills changed since the last save
+		std::array<int32_t, CUSTOMSKILL_LAST + 1> customSkills = {};
+		std::bitset<CUSTOMSKILL_LAST + 1> customSkillChanges;
+
+		struct InventoryIndexEntry {
+			uint32_t count = 0;
+			std::vector<Item*> items;
+		};
+
+		// items by id and all containers in the inventory, rebuilt on the first
+		// query after the inventory changed
+		mutable std::unordered_map<uint16_t, InventoryIndexEntry> inventoryIndex;
+		mutable std::vector<Container*> inventoryContainers;
+		mutable bool inventoryIndexChanged = true;
 
 		std::map<uint8_t, OpenContainer> openContainers;
 		std::map<uint32_t, DepotLocker_ptr> depotLockerMap;
@@ -1345,6 +1393,10 @@ class Player final : public Creature, public Cylinder {
 		static uint32_t playerAutoID;
 
 		void updateItemsLight(bool internal = false);
+		void updateInventoryIndex() const;
+#ifndef NDEBUG
+		void checkInventoryIndex() const;
+#endif
 		int32_t getStepSpeed() const override {
 			return std::max<int32_t>(PLAYER_MIN_SPEED, std::min<int32_t>(PLAYER_MAX_SPEED, getSpeed()));
 		}
@@ -8,6 +8,7 @@
 #include "ban.h"
 #include "condition.h"
 #include "configmanager.h"
+#include "databasetasks.h"
 #include "depotchest.h"
 #include "game.h"
 #include "inbox.h"
@@ -102,6 +103,60 @@ namespace {
 		return waitList.size();
 	}
 
+	std::string getWrittenBytes(const NetworkMessage& msg) {
+		return {reinterpret_cast<const char*>(msg.getBuffer()) + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getLength()};
+	}
+
+	const TileItemsEncoding& getItemsEncoding(const Tile& tile) {
+		if (const TileItemsEncoding* encoding = tile.getItemsEncoding()) {
+			return *encoding;
+		}
+
+		auto encoding = std::make_unique<TileItemsEncoding>();
+
+		NetworkMessage msg;
+		msg.add<uint16_t>(0x00); //environmental effects
+
+		int32_t count;
+		Item* ground = tile.getGround();
+		if (ground) {
+			msg.addItem(ground);
+			count = 1;
+		} else {
+			count = 0;
+		}
+
+		const TileItemVector* items = tile.getItemList();
+		if (items) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				msg.addItem(*it);
+
+				if (++count == MAX_STACKPOS) {
+					break;
+				}
+			}
+		}
+
+		encoding->topItems = getWrittenBytes(msg);
+		encoding->topItemCount = count;
+
+		// without creatures on the tile this many down items fit
+		if (items && count < MAX_STACKPOS) {
+			msg.reset();
+			for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
+				msg.addItem(*it);
+				encoding->downItemEnds.push_back(msg.getLength());
+
+				if (++count == MAX_STACKPOS) {
+					break;
+				}
+			}
+			encoding->downItems = getWrittenBytes(msg);
+		}
+
+		return tile.setItemsEncoding(std::move(encoding));
+	}
+
 }
 
 void ProtocolGame::release() {
@@ -117,53 +172,96 @@ void ProtocolGame::release() {
 	Protocol::release();
 }
 
-void ProtocolGame::login(const std::string& name, uint32_t accountId, OperatingSystem_t operatingSystem) {
+void ProtocolGame::authenticate(Database& db, const std::string& accountName, const std::string& password, const std::string& characterName, const std::string& token, uint32_t tokenTime, OperatingSystem_t operatingSystem, int64_t queuedAt) {
+	//database thread
+	if (isConnectionExpired()) {
+		return;
+	}
+
+	if (const auto& banInfo = IOBan::getIpBanInfo(db, getIP())) {
+		disconnectClient(fmt::format("Your IP has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason));
+		return;
+	}
+
+	auto[accountId, charName] = IOLoginData::gameworldAuthentication(db, accountName, password, characterName, token, tokenTime);
+	if (accountId == 0) {
+		disconnectClient("Account name or password is not correct.");
+		return;
+	}
+
+	// everything the login checks need is fetched here, so a client on the waiting list
+	// does not get its whole character loaded each time it retries
+	PlayerPreload preload;
+	if (!IOLoginData::preloadPlayer(db, charName, preload)) {
+		disconnectClient("Your character could not be loaded.");
+		return;
+	}
+
+	if (IOBan::isPlayerNamelocked(db, preload.guid)) {
+		disconnectClient("Your character has been namelocked.");
+		return;
+	}
+
+	std::string banMessage;
+	if (const auto& banInfo = IOBan::getAccountBanInfo(db, accountId)) {
+		if (banInfo->expiresAt > 0) {
+			banMessage = fmt::format("Your account has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason);
+		} else {
+			banMessage = fmt::format("Your account has been permanently banned by {:s}.\n\nReason specified:\n{:s}", banInfo->bannedBy, banInfo->reason);
+		}
+	}
+
+	int64_t authenticateTime = OTSYS_TIME() - queuedAt;
+	g_dispatcher.addTask([=, thisPtr = getThis(), charName = std::move(charName), banMessage = std::move(banMessage)]() {
+		thisPtr->login(charName, preload, banMessage, operatingSystem, authenticateTime);
+	});
+}
+
+void ProtocolGame::login(const std::string& name, const PlayerPreload& preload, const std::string& banMessage, OperatingSystem_t operatingSystem, int64_t authenticateTime) {
 	//dispatcher thread
 	Player* foundPlayer = g_game.getPlayerByName(name);
 	if (!foundPlayer || getBoolean(ConfigManager::ALLOW_CLONES)) {
-		player = new Player(getThis());
-		player->setName(name);
+		// the player is loaded on the database thread and is not known to the
+		// game until placePlayer, so nothing else can reach it in between
+		Player* newPlayer = new Player(getThis());
+		newPlayer->setName(name);
+
+		newPlayer->incrementReferenceCounter();
+		newPlayer->setID();
 
-		player->incrementReferenceCounter();
-		player->setID();
+		auto reject = [=, this](const std::string& message) {
+			disconnectClient(message);
+			newPlayer->decrementReferenceCounter();
+		};
 
-		if (!IOLoginData::preloadPlayer(player, name)) {
-			disconnectClient("Your character could not be loaded.");
+		if (!IOLoginData::applyPreload(newPlayer, preload)) {
+			reject("Your character could not be loaded.");
 			return;
 		}
 
-		if (IOBan::isPlayerNamelocked(player->getGUID())) {
-			disconnectClient("Your character has been namelocked.");
+		if (g_game.getGameState() == GAME_STATE_CLOSING && !newPlayer->hasFlag(PlayerFlag_CanAlwaysLogin)) {
+			reject("The game is just going down.\nPlease try again later.");
 			return;
 		}
 
-		if (g_game.getGameState() == GAME_STATE_CLOSING && !player->hasFlag(PlayerFlag_CanAlwaysLogin)) {
-			disconnectClient("The game is just going down.\nPlease try again later.");
+		if (g_game.getGameState() == GAME_STATE_CLOSED && !newPlayer->hasFlag(PlayerFlag_CanAlwaysLogin)) {
+			reject("Server is currently closed.\nPlease try again later.");
 			return;
 		}
 
-		if (g_game.getGameState() == GAME_STATE_CLOSED && !player->hasFlag(PlayerFlag_CanAlwaysLogin)) {
-			disconnectClient("Server is currently closed.\nPlease try again later.");
+		if (getBoolean(ConfigManager::ONE_PLAYER_ON_ACCOUNT) && newPlayer->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && g_game.getPlayerByAccount(newPlayer->getAccount())) {
+			reject("You may only login with one character\nof your account at the same time.");
 			return;
 		}
 
-		if (getBoolean(ConfigManager::ONE_PLAYER_ON_ACCOUNT) && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && g_game.getPlayerByAccount(player->getAccount())) {
-			disconnectClient("You may only login with one character\nof your account at the same time.");
+		if (!banMessage.empty() && !newPlayer->hasFlag(PlayerFlag_CannotBeBanned)) {
+			reject(banMessage);
 			return;
 		}
 
-		if (!player->hasFlag(PlayerFlag_CannotBeBanned)) {
-			if (const auto& banInfo = IOBan::getAccountBanInfo(accountId)) {
-				if (banInfo->expiresAt > 0) {
-					disconnectClient(fmt::format("Your account has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason));
-				} else {
-					disconnectClient(fmt::format("Your account has been permanently banned by {:s}.\n\nReason specified:\n{:s}", banInfo->bannedBy, banInfo->reason));
-				}
-				return;
-			}
-		}
+		if (std::size_t currentSlot = clientLogin(*newPlayer)) {
+			newPlayer->decrementReferenceCounter();
 
-		if (std::size_t currentSlot = clientLogin(*player)) {
 			uint8_t retryTime = getWaitTime(currentSlot);
 			auto output = net::make_output_message();
 			output->addByte(0x16);
@@ -174,46 +272,111 @@ void ProtocolGame::login(const std::string& name, uint32_t accountId, OperatingS
 			return;
 		}
 
-		if (!IOLoginData::loadPlayerById(player, player->getGUID())) {
-			disconnectClient("Your character could not be loaded.");
-			return;
-		}
-
-		player->setOperatingSystem(operatingSystem);
+		// the guild cache belongs to the dispatcher, the load only learns whether it can skip the guild
+		const uint32_t cachedGuildId = g_game.getGuild(preload.guildId) ? preload.guildId : 0;
 
-		if (!g_game.placeCreature(player, player->getLoginPosition())) {
-			if (!g_game.placeCreature(player, player->getTemplePosition(), false, true)) {
-				disconnectClient("Temple position is wrong. Contact the administrator.");
-				return;
-			}
+		int64_t queuedAt = OTSYS_TIME();
+		if (!g_databaseTasks.addJob([=, thisPtr = getThis()](Database& db) { thisPtr->loadPlayer(db, newPlayer, cachedGuildId, operatingSystem, authenticateTime, queuedAt); })) {
+			reject("Your character could not be loaded.");
 		}
+		return;
+	}
 
-		if (operatingSystem >= CLIENTOS_OTCLIENT_LINUX) {
-			player->registerCreatureEvent("ExtendedOpcode");
-		}
+	if (eventConnect != 0 || !getBoolean(ConfigManager::REPLACE_KICK_ON_LOGIN)) {
+		//Already trying to connect
+		disconnectClient("You are already logged in.");
+		return;
+	}
+
+	if (foundPlayer->client) {
+		foundPlayer->disconnect();
+		foundPlayer->isConnecting = true;
 
-		player->lastIP = player->getIP();
-		player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
-		acceptPackets = true;
+		eventConnect = g_scheduler.addEvent(createSchedulerTask(1000, [=, thisPtr = getThis(), playerID = foundPlayer->getID()]() {
+			thisPtr->connect(playerID, operatingSystem);
+		}));
 	} else {
-		if (eventConnect != 0 || !getBoolean(ConfigManager::REPLACE_KICK_ON_LOGIN)) {
-			//Already trying to connect
-			disconnectClient("You are already logged in.");
-			return;
-		}
+		connect(foundPlayer->getID(), operatingSystem);
+	}
 
-		if (foundPlayer->client) {
-			foundPlayer->disconnect();
-			foundPlayer->isConnecting = true;
+	net::insert_protocol_to_autosend(shared_from_this());
+}
 
-			eventConnect = g_scheduler.addEvent(createSchedulerTask(1000, [=, thisPtr = getThis(), playerID = foundPlayer->getID()]() {
-				thisPtr->connect(playerID, operatingSystem);
-			}));
-		} else {
-			connect(foundPlayer->getID(), operatingSystem);
+void ProtocolGame::loadPlayer(Database& db, Player* newPlayer, uint32_t cachedGuildId, OperatingSystem_t operatingSystem, int64_t authenticateTime, int64_t queuedAt) {
+	//database thread
+	if (isConnectionExpired()) {
+		g_dispatcher.addTask([=]() { newPlayer->decrementReferenceCounter(); });
+		return;
+	}
+
+	PlayerBindings bindings;
+	bindings.cachedGuildId = cachedGuildId;
+	if (!IOLoginData::loadPlayerById(db, newPlayer, newPlayer->getGUID(), bindings)) {
+		disconnectClient("Your character could not be loaded.");
+		g_dispatcher.addTask([=]() { newPlayer->decrementReferenceCounter(); });
+		return;
+	}
+
+	int64_t loadedAt = OTSYS_TIME();
+	g_dispatcher.addTask([=, thisPtr = getThis(), bindings = std::move(bindings)]() mutable {
+		thisPtr->placePlayer(newPlayer, bindings, operatingSystem, authenticateTime, loadedAt - queuedAt, loadedAt);
+	});
+}
+
+void ProtocolGame::placePlayer(Player* newPlayer, PlayerBindings& bindings, OperatingSystem_t operatingSystem, int64_t authenticateTime, int64_t loadTime, int64_t loadedAt) {
+	//dispatcher thread
+	if (isConnectionExpired()) {
+		newPlayer->decrementReferenceCounter();
+		return;
+	}
+
+	player = newPlayer;
+
+	// the game state may have changed while the player was loaded, the waiting
+	// list was already passed in login
+	if (!getBoolean(ConfigManager::ALLOW_CLONES) && g_game.getPlayerByName(player->getName())) {
+		disconnectClient("You are already logged in.");
+		return;
+	}
+
+	if (g_game.getGameState() == GAME_STATE_CLOSING && !player->hasFlag(PlayerFlag_CanAlwaysLogin)) {
+		disconnectClient("The game is just going down.\nPlease try again later.");
+		return;
+	}
+
+	if (g_game.getGameState() == GAME_STATE_CLOSED && !player->hasFlag(PlayerFlag_CanAlwaysLogin)) {
+		disconnectClient("Server is currently closed.\nPlease try again later.");
+		return;
+	}
+
+	if (getBoolean(ConfigManager::ONE_PLAYER_ON_ACCOUNT) && player->getAccountType() < ACCOUNT_TYPE_GAMEMASTER && g_game.getPlayerByAccount(player->getAccount())) {
+		disconnectClient("You may only login with one character\nof your account at the same time.");
+		return;
+	}
+
+	if (!IOLoginData::bindPlayer(player, bindings)) {
+		disconnectClient("Your character could not be loaded.");
+		return;
+	}
+	player->setOperatingSystem(operatingSystem);
+
+	if (!g_game.placeCreature(player, player->getLoginPosition())) {
+		if (!g_game.placeCreature(player, player->getTemplePosition(), false, true)) {
+			disconnectClient("Temple position is wrong. Contact the administrator.");
+			return;
 		}
 	}
 
+	if (operatingSystem >= CLIENTOS_OTCLIENT_LINUX) {
+		player->registerCreatureEvent("ExtendedOpcode");
+	}
+
+	player->lastIP = player->getIP();
+	player->lastLoginSaved = std::max<time_t>(time(nullptr), player->lastLoginSaved + 1);
+	acceptPackets = true;
+
+	g_game.addLoginTimes(authenticateTime, loadTime, OTSYS_TIME() - loadedAt);
+
 	net::insert_protocol_to_autosend(shared_from_this());
 }
 
@@ -376,20 +539,11 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage& msg) {
 		return;
 	}
 
-	if (const auto& banInfo = IOBan::getIpBanInfo(getIP())) {
-		disconnectClient(fmt::format("Your IP has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason));
-		return;
-	}
-
-	auto[accountId, charName] = IOLoginData::gameworldAuthentication(accountName, password, characterName, token, tokenTime);
-	if (accountId == 0) {
-		disconnectClient("Account name or password is not correct.");
-		return;
+	if (!g_databaseTasks.addJob([=, thisPtr = getThis(), accountName = std::string{accountName}, password = std::string{password}, characterName = std::string{characterName}, token = std::string{token}, queuedAt = OTSYS_TIME()](Database& db) {
+		thisPtr->authenticate(db, accountName, password, characterName, token, tokenTime, operatingSystem, queuedAt);
+	})) {
+		disconnectClient("Gameworld is not accepting logins right now.\nPlease try again later.");
 	}
-
-	g_dispatcher.addTask([=, thisPtr = getThis()]() {
-		thisPtr->login(charName, accountId, operatingSystem);
-	});
 }
 
 void ProtocolGame::onConnect() {
@@ -557,27 +711,10 @@ void ProtocolGame::parsePacket(NetworkMessage& msg) {
 }
 
 void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg) {
-	msg.add<uint16_t>(0x00); //environmental effects
+	const TileItemsEncoding& encoding = getItemsEncoding(*tile);
+	msg.addBytes(encoding.topItems.data(), encoding.topItems.size());
 
-	int32_t count;
-	Item* ground = tile->getGround();
-	if (ground) {
-		msg.addItem(ground);
-		count = 1;
-	} else {
-		count = 0;
-	}
-
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			msg.addItem(*it);
-
-			if (++count == MAX_STACKPOS) {
-				break;
-			}
-		}
-	}
+	int32_t count = encoding.topItemCount;
 
 	const CreatureVector* creatures = tile->getCreatures();
 	if (creatures) {
@@ -595,14 +732,9 @@ void ProtocolGame::GetTileDescription(const Tile* tile, NetworkMessage& msg) {
 		}
 	}
 
-	if (items && count < MAX_STACKPOS) {
-		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			msg.addItem(*it);
-
-			if (++count == MAX_STACKPOS) {
-				return;
-			}
-		}
+	if (count < MAX_STACKPOS && !encoding.downItemEnds.empty()) {
+		std::size_t downItems = std::min<std::size_t>(MAX_STACKPOS - count, encoding.downItemEnds.size());
+		msg.addBytes(encoding.downItems.data(), encoding.downItemEnds[downItems - 1]);
 	}
 }
 
@@ -631,10 +763,18 @@ void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t wi
 }
 
 void ProtocolGame::GetFloorDescription(NetworkMessage& msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t& skip) {
+	// the client expects the tiles column by column, the map hands them out leaf by leaf
+	std::array<const Tile*, (Map::maxClientViewportX * 2 + 2) * (Map::maxClientViewportY * 2 + 2)> tiles{};
+	assert(width * height <= static_cast<int32_t>(tiles.size()));
+
+	g_game.map.visitTiles(x + offset, y + offset, z, width, height, [&](const Tile* tile, int32_t dx, int32_t dy) {
+		tiles[dx * height + dy] = tile;
+		return false;
+	});
+
 	for (int32_t nx = 0; nx < width; nx++) {
 		for (int32_t ny = 0; ny < height; ny++) {
-			Tile* tile = g_game.map.getTile(x + nx + offset, y + ny + offset, z);
-			if (tile) {
+			if (const Tile* tile = tiles[nx * height + ny]) {
 				if (skip >= 0) {
 					msg.addByte(skip);
 					msg.addByte(0xFF);
@@ -1485,7 +1625,7 @@ void ProtocolGame::sendChannelsDialog() {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers) {
+void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelName, const UserList* channelUsers, const InvitedMap* invitedUsers) {
 	NetworkMessage msg;
 	msg.addByte(0xAC);
 
@@ -1494,8 +1634,8 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelNam
 
 	if (channelUsers) {
 		msg.add<uint16_t>(channelUsers->size());
-		for (const auto& it : *channelUsers) {
-			msg.addString(it.second->getName());
+		for (const Player* user : *channelUsers) {
+			msg.addString(user->getName());
 		}
 	} else {
 		msg.add<uint16_t>(0x00);
@@ -1514,13 +1654,7 @@ void ProtocolGame::sendChannel(uint16_t channelId, const std::string& channelNam
 
 void ProtocolGame::sendChannelMessage(const std::string& author, const std::string& text, SpeakClasses type, uint16_t channel) {
 	NetworkMessage msg;
-	msg.addByte(0xAA);
-	msg.add<uint32_t>(0x00);
-	msg.addString(author);
-	msg.add<uint16_t>(0x00);
-	msg.addByte(type);
-	msg.add<uint16_t>(channel);
-	msg.addString(text);
+	AddChannelMessage(msg, author, text, type, channel);
 	writeToOutputBuffer(msg);
 }
 
@@ -2181,33 +2315,27 @@ void ProtocolGame::sendCreatureTurn(const Creature* creature, uint32_t stackpos)
 
 void ProtocolGame::sendCreatureSay(const Creature* creature, SpeakClasses type, const std::string& text, const Position* pos/* = nullptr*/) {
 	NetworkMessage msg;
-	msg.addByte(0xAA);
-
-	static uint32_t statementId = 0;
-	msg.add<uint32_t>(++statementId);
-
-	msg.addString(creature->getName());
+	AddCreatureSay(msg, creature, type, text, pos ? *pos : creature->getPosition());
+	writeToOutputBuffer(msg);
+}
 
-	//Add level only for players
-	if (const Player* speaker = creature->getPlayer()) {
-		msg.add<uint16_t>(speaker->getLevel());
-	} else {
-		msg.add<uint16_t>(0x00);
-	}
+void ProtocolGame::sendToChannel(const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId) {
+	NetworkMessage msg;
+	AddCreatureChannelMessage(msg, creature, type, text, channelId);
+	writeToOutputBuffer(msg);
+}
 
+void ProtocolGame::AddChannelMessage(NetworkMessage& msg, const std::string& author, const std::string& text, SpeakClasses type, uint16_t channelId) {
+	msg.addByte(0xAA);
+	msg.add<uint32_t>(0x00);
+	msg.addString(author);
+	msg.add<uint16_t>(0x00);
 	msg.addByte(type);
-	if (pos) {
-		msg.addPosition(*pos);
-	} else {
-		msg.addPosition(creature->getPosition());
-	}
-
+	msg.add<uint16_t>(channelId);
 	msg.addString(text);
-	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendToChannel(const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId) {
-	NetworkMessage msg;
+void ProtocolGame::AddCreatureChannelMessage(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId) {
 	msg.addByte(0xAA);
 
 	static uint32_t statementId = 0;
@@ -2227,7 +2355,26 @@ void ProtocolGame::sendToChannel(const Creature* creature, SpeakClasses type, co
 	msg.addByte(type);
 	msg.add<uint16_t>(channelId);
 	msg.addString(text);
-	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddCreatureSay(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, const Position& pos) {
+	msg.addByte(0xAA);
+
+	static uint32_t statementId = 0;
+	msg.add<uint32_t>(++statementId);
+
+	msg.addString(creature->getName());
+
+	//Add level only for players
+	if (const Player* speaker = creature->getPlayer()) {
+		msg.add<uint16_t>(speaker->getLevel());
+	} else {
+		msg.add<uint16_t>(0x00);
+	}
+
+	msg.addByte(type);
+	msg.addPosition(pos);
+	msg.addString(text);
 }
 
 void ProtocolGame::sendPrivateMessage(const Player* speaker, SpeakClasses type, const std::string& text) {
@@ -2289,10 +2436,7 @@ void ProtocolGame::sendPingBack() {
 
 void ProtocolGame::sendDistanceShoot(const Position& from, const Position& to, uint8_t type) {
 	NetworkMessage msg;
-	msg.addByte(0x85);
-	msg.addPosition(from);
-	msg.addPosition(to);
-	msg.addByte(type);
+	AddDistanceShoot(msg, from, to, type);
 	writeToOutputBuffer(msg);
 }
 
@@ -2302,14 +2446,30 @@ void ProtocolGame::sendMagicEffect(const Position& pos, uint8_t type) {
 	}
 
 	NetworkMessage msg;
-	msg.addByte(0x83);
-	msg.addPosition(pos);
-	msg.addByte(type);
+	AddMagicEffect(msg, pos, type);
 	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCreatureHealth(const Creature* creature) {
 	NetworkMessage msg;
+	AddCreatureHealth(msg, creature);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddDistanceShoot(NetworkMessage& msg, const Position& from, const Position& to, uint8_t type) {
+	msg.addByte(0x85);
+	msg.addPosition(from);
+	msg.addPosition(to);
+	msg.addByte(type);
+}
+
+void ProtocolGame::AddMagicEffect(NetworkMessage& msg, const Position& pos, uint8_t type) {
+	msg.addByte(0x83);
+	msg.addPosition(pos);
+	msg.addByte(type);
+}
+
+void ProtocolGame::AddCreatureHealth(NetworkMessage& msg, const Creature* creature) {
 	msg.addByte(0x8C);
 	msg.add<uint32_t>(creature->getID());
 
@@ -2318,7 +2478,6 @@ void ProtocolGame::sendCreatureHealth(const Creature* creature) {
 	} else {
 		msg.addByte(std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100));
 	}
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendFYIBox(const std::string& message) {
@@ -2343,11 +2502,15 @@ void ProtocolGame::sendAddTileItem(const Position& pos, uint32_t stackpos, const
 	}
 
 	NetworkMessage msg;
+	AddTileItem(msg, pos, stackpos, item);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddTileItem(NetworkMessage& msg, const Position& pos, uint32_t stackpos, const Item* item) {
 	msg.addByte(0x6A);
 	msg.addPosition(pos);
 	msg.addByte(stackpos);
 	msg.addItem(item);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendUpdateTileItem(const Position& pos, uint32_t stackpos, const Item* item) {
@@ -2356,11 +2519,15 @@ void ProtocolGame::sendUpdateTileItem(const Position& pos, uint32_t stackpos, co
 	}
 
 	NetworkMessage msg;
+	UpdateTileItem(msg, pos, stackpos, item);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::UpdateTileItem(NetworkMessage& msg, const Position& pos, uint32_t stackpos, const Item* item) {
 	msg.addByte(0x6B);
 	msg.addPosition(pos);
 	msg.addByte(stackpos);
 	msg.addItem(item);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendRemoveTileThing(const Position& pos, uint32_t stackpos) {
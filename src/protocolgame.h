@@ -10,10 +10,13 @@
 #include "tasks.h"
 
 class Container;
+class Database;
 class Game;
 class NetworkMessage;
 class Player;
 class ProtocolGame;
+struct PlayerBindings;
+struct PlayerPreload;
 class Quest;
 class Tile;
 class TrackedQuest;
@@ -48,17 +51,33 @@ class ProtocolGame final : public Protocol {
 
 		explicit ProtocolGame(Connection_ptr connection) : Protocol(connection) {}
 
-		void login(const std::string& name, uint32_t accountId, OperatingSystem_t operatingSystem);
 		void logout(bool displayEffect, bool forced);
 
 		uint16_t getVersion() const {
 			return version;
 		}
 
+		// channel messages are encoded once and then copied to every member
+		static void AddChannelMessage(NetworkMessage& msg, const std::string& author, const std::string& text, SpeakClasses type, uint16_t channelId);
+		static void AddCreatureChannelMessage(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId);
+
+		// world updates that look the same to every spectator, encoded once per broadcast
+		static void AddCreatureSay(NetworkMessage& msg, const Creature* creature, SpeakClasses type, const std::string& text, const Position& pos);
+		static void AddCreatureHealth(NetworkMessage& msg, const Creature* creature);
+		static void AddMagicEffect(NetworkMessage& msg, const Position& pos, uint8_t type);
+		static void AddDistanceShoot(NetworkMessage& msg, const Position& from, const Position& to, uint8_t type);
+		static void AddTileItem(NetworkMessage& msg, const Position& pos, uint32_t stackpos, const Item* item);
+		static void UpdateTileItem(NetworkMessage& msg, const Position& pos, uint32_t stackpos, const Item* item);
+
 	private:
 		ProtocolGame_ptr getThis() {
 			return std::static_pointer_cast<ProtocolGame>(shared_from_this());
 		}
+		// login stages, authenticate and loadPlayer run on the database thread with its connection
+		void authenticate(Database& db, const std::string& accountName, const std::string& password, const std::string& characterName, const std::string& token, uint32_t tokenTime, OperatingSystem_t operatingSystem, int64_t queuedAt);
+		void login(const std::string& name, const PlayerPreload& preload, const std::string& banMessage, OperatingSystem_t operatingSystem, int64_t authenticateTime);
+		void loadPlayer(Database& db, Player* newPlayer, uint32_t cachedGuildId, OperatingSystem_t operatingSystem, int64_t authenticateTime, int64_t queuedAt);
+		void placePlayer(Player* newPlayer, PlayerBindings& bindings, OperatingSystem_t operatingSystem, int64_t authenticateTime, int64_t loadTime, int64_t loadedAt);
 		void connect(uint32_t playerId, OperatingSystem_t operatingSystem);
 		void disconnectClient(const std::string& message) const;
 		void writeToOutputBuffer(const NetworkMessage& msg);
@@ -152,7 +171,7 @@ class ProtocolGame final : public Protocol {
 		void sendClosePrivate(uint16_t channelId);
 		void sendCreatePrivateChannel(uint16_t channelId, const std::string& channelName);
 		void sendChannelsDialog();
-		void sendChannel(uint16_t channelId, const std::string& channelName, const UsersMap* channelUsers, const InvitedMap* invitedUsers);
+		void sendChannel(uint16_t channelId, const std::string& channelName, const UserList* channelUsers, const InvitedMap* invitedUsers);
 		void sendOpenPrivateChannel(const std::string& receiver);
 		void sendToChannel(const Creature* creature, SpeakClasses type, const std::string& text, uint16_t channelId);
 		void sendPrivateMessage(const Player* speaker, SpeakClasses type, const std::string& text);
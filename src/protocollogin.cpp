@@ -7,6 +7,7 @@
 
 #include "ban.h"
 #include "configmanager.h"
+#include "databasetasks.h"
 #include "game.h"
 #include "iologindata.h"
 #include "outputmessage.h"
@@ -56,8 +57,12 @@ void ProtocolLogin::disconnectClient(const std::string& message, uint16_t versio
 	disconnect();
 }
 
-void ProtocolLogin::getCharacterList(const std::string& accountName, const std::string& password, const std::string& token, uint16_t version) {
-	Database& db = Database::getInstance();
+void ProtocolLogin::getCharacterList(Database& db, const std::string& accountName, const std::string& password, const std::string& token, uint16_t version) {
+	//database thread
+	if (const auto& banInfo = IOBan::getIpBanInfo(db, getIP())) {
+		disconnectClient(fmt::format("Your IP has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason), version);
+		return;
+	}
 
 	DBResult_ptr result = db.storeQuery(fmt::format("SELECT `id`, UNHEX(`password`) AS `password`, `secret`, `premium_ends_at` FROM `accounts` WHERE `name` = {:s}", db.escapeString(accountName)));
 	if (!result) {
@@ -84,15 +89,27 @@ void ProtocolLogin::getCharacterList(const std::string& accountName, const std::
 
 	uint32_t ticks = time(nullptr) / AUTHENTICATOR_PERIOD;
 
-	auto output = net::make_output_message();
 	if (!key.empty()) {
 		if (token.empty() || !(token == generateToken(key, ticks) || token == generateToken(key, ticks - 1) || token == generateToken(key, ticks + 1))) {
+			auto output = net::make_output_message();
 			output->addByte(0x0D);
 			output->addByte(0);
 			send(output);
 			disconnect();
 			return;
 		}
+	}
+
+	// the online state of the characters is only known to the dispatcher
+	g_dispatcher.addTask([=, thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), characters = std::move(characters), hasKey = !key.empty()]() {
+		thisPtr->sendCharacterList(accountName, password, token, ticks, hasKey, premiumEndsAt, characters);
+	});
+}
+
+void ProtocolLogin::sendCharacterList(const std::string& accountName, const std::string& password, const std::string& token, uint32_t ticks, bool hasKey, time_t premiumEndsAt, const std::vector<std::string>& characters) {
+	//dispatcher thread
+	auto output = net::make_output_message();
+	if (hasKey) {
 		output->addByte(0x0C);
 		output->addByte(0);
 	}
@@ -217,11 +234,6 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage& msg) {
 		return;
 	}
 
-	if (const auto& banInfo = IOBan::getIpBanInfo(connection->getIP())) {
-		disconnectClient(fmt::format("Your IP has been banned until {:s} by {:s}.\n\nReason specified:\n{:s}", formatDateShort(banInfo->expiresAt), banInfo->bannedBy, banInfo->reason), version);
-		return;
-	}
-
 	auto accountName = msg.getString();
 	if (accountName.empty()) {
 		disconnectClient("Invalid account name.", version);
@@ -243,7 +255,9 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage& msg) {
 
 	auto authToken = msg.getString();
 
-	g_dispatcher.addTask([=, thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), accountName = std::string{accountName}, password = std::string{password}, authToken = std::string{authToken}]() {
-		thisPtr->getCharacterList(accountName, password, authToken, version);
-	});
+	if (!g_databaseTasks.addJob([=, thisPtr = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), accountName = std::string{accountName}, password = std::string{password}, authToken = std::string{authToken}](Database& db) {
+		thisPtr->getCharacterList(db, accountName, password, authToken, version);
+	})) {
+		disconnectClient("Login server is not accepting logins right now.\nPlease try again later.", version);
+	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "protocol.h"
 
+class Database;
 class NetworkMessage;
 
 class ProtocolLogin : public Protocol {
@@ -25,7 +26,8 @@ class ProtocolLogin : public Protocol {
 	private:
 		void disconnectClient(const std::string& message, uint16_t version);
 
-		void getCharacterList(const std::string& accountName, const std::string& password, const std::string& token, uint16_t version);
+		void getCharacterList(Database& db, const std::string& accountName, const std::string& password, const std::string& token, uint16_t version);
+		void sendCharacterList(const std::string& accountName, const std::string& password, const std::string& token, uint32_t ticks, bool hasKey, time_t premiumEndsAt, const std::vector<std::string>& characters);
 };
 
 #endif // FS_PROTOCOLLOGIN_H
\ No newline at end of file
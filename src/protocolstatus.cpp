@@ -11,7 +11,8 @@
 
 extern Game g_game;
 
-std::map<Connection::Address, int64_t> ProtocolStatus::ipConnectMap;
+std::unordered_map<Connection::Address, int64_t, ProtocolStatus::AddressHash> ProtocolStatus::ipConnectMap;
+int64_t ProtocolStatus::ipConnectMapPurgeTime = 0;
 const uint64_t ProtocolStatus::start = OTSYS_TIME();
 
 enum RequestedInfo_t : uint16_t {
@@ -25,58 +26,20 @@ enum RequestedInfo_t : uint16_t {
 	REQUEST_SERVER_SOFTWARE_INFO = 1 << 7,
 };
 
-void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg) {
-	const static auto acceptorAddress = boost::asio::ip::make_address(getString(ConfigManager::IP));
-
-	const auto& ip = getIP();
-
-	if (!ip.is_loopback() && ip != acceptorAddress) {
-		if (auto it = ipConnectMap.find(ip);
-		    it != ipConnectMap.end() &&
-		    (OTSYS_TIME() < (it->second + getNumber(ConfigManager::STATUSQUERY_TIMEOUT)))) {
-			disconnect();
-			return;
-		}
-	}
+namespace {
 
-	ipConnectMap[ip] = OTSYS_TIME();
-
-	switch (msg.getByte()) {
-		//XML info protocol
-		case 0xFF: {
-			if (msg.getString(4) == "info") {
-				g_dispatcher.addTask([thisPtr = std::static_pointer_cast<ProtocolStatus>(shared_from_this())]() {
-					thisPtr->sendStatusString();
-				});
-				return;
-			}
-			break;
-		}
+// sections that depend on more than counters are always built on the dispatcher
+constexpr uint16_t LIVE_INFO_SECTIONS = REQUEST_EXT_PLAYERS_INFO | REQUEST_PLAYER_STATUS_INFO;
 
-		//Another ServerInfo protocol
-		case 0x01: {
-			uint16_t requestedInfo = msg.get<uint16_t>(); // only a Byte is necessary, though we could add new info here
-			std::string characterName;
-			if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
-				characterName = msg.getString();
-			}
-			g_dispatcher.addTask([=, thisPtr = std::static_pointer_cast<ProtocolStatus>(shared_from_this()), characterName = std::move(characterName)]() {
-					thisPtr->sendInfo(requestedInfo, characterName);
-			});
-			return;
-		}
+std::mutex snapshotLock;
+std::shared_ptr<const StatusSnapshot> currentSnapshot;
+bool snapshotRefreshQueued = false;
 
-		default:
-			break;
-	}
-	disconnect();
+bool isSnapshotExpired(const StatusSnapshot& snapshot) {
+	return OTSYS_TIME() >= snapshot.createdAt + getNumber(ConfigManager::STATUS_CACHE_TIME);
 }
 
-void ProtocolStatus::sendStatusString() {
-	auto output = net::make_output_message();
-
-	setRawMessages(true);
-
+std::string buildStatusString() {
 	pugi::xml_document doc;
 
 	pugi::xml_node decl = doc.prepend_child(pugi::node_declaration);
@@ -133,52 +96,220 @@ void ProtocolStatus::sendStatusString() {
 
 	std::ostringstream ss;
 	doc.save(ss, "", pugi::format_raw);
+	return ss.str();
+}
+
+std::string encodeSection(const NetworkMessage& msg) {
+	return {reinterpret_cast<const char*>(msg.getBuffer()) + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getLength()};
+}
+
+std::shared_ptr<const StatusSnapshot> createSnapshot() {
+	auto snapshot = std::make_shared<StatusSnapshot>();
+	snapshot->createdAt = OTSYS_TIME();
+	snapshot->statusString = buildStatusString();
+
+	auto& sections = snapshot->infoSections;
+	{
+		NetworkMessage msg;
+		msg.addByte(0x10);
+		msg.addString(getString(ConfigManager::SERVER_NAME));
+		msg.addString(getString(ConfigManager::IP));
+		msg.addString(std::to_string(getNumber(ConfigManager::LOGIN_PORT)));
+		sections[0] = encodeSection(msg);
+	}
+
+	{
+		NetworkMessage msg;
+		msg.addByte(0x11);
+		msg.addString(getString(ConfigManager::OWNER_NAME));
+		msg.addString(getString(ConfigManager::OWNER_EMAIL));
+		sections[1] = encodeSection(msg);
+	}
+
+	{
+		// the uptime is appended when the section is sent
+		NetworkMessage msg;
+		msg.addByte(0x12);
+		msg.addString(getString(ConfigManager::MOTD));
+		msg.addString(getString(ConfigManager::LOCATION));
+		msg.addString(getString(ConfigManager::URL));
+		sections[2] = encodeSection(msg);
+	}
+
+	{
+		NetworkMessage msg;
+		msg.addByte(0x20);
+		msg.add<uint32_t>(g_game.getPlayersOnline());
+		msg.add<uint32_t>(getNumber(ConfigManager::MAX_PLAYERS));
+		msg.add<uint32_t>(g_game.getPlayersRecord());
+		sections[3] = encodeSection(msg);
+	}
+
+	{
+		NetworkMessage msg;
+		msg.addByte(0x30);
+		msg.addString(getString(ConfigManager::MAP_NAME));
+		msg.addString(getString(ConfigManager::MAP_AUTHOR));
+		uint32_t mapWidth, mapHeight;
+		g_game.getMapDimensions(mapWidth, mapHeight);
+		msg.add<uint16_t>(mapWidth);
+		msg.add<uint16_t>(mapHeight);
+		sections[4] = encodeSection(msg);
+	}
+
+	{
+		NetworkMessage msg;
+		msg.addByte(0x23); // server software info
+		msg.addString(STATUS_SERVER_NAME);
+		msg.addString(STATUS_SERVER_VERSION);
+		msg.addString(CLIENT_VERSION_STR);
+		sections[7] = encodeSection(msg);
+	}
+	return snapshot;
+}
+
+// dispatcher thread, rebuilds the snapshot once it expired
+std::shared_ptr<const StatusSnapshot> refreshSnapshot() {
+	{
+		std::lock_guard<std::mutex> lockGuard(snapshotLock);
+		snapshotRefreshQueued = false;
+		if (currentSnapshot && !isSnapshotExpired(*currentSnapshot)) {
+			return currentSnapshot;
+		}
+	}
+
+	auto snapshot = createSnapshot();
+
+	std::lock_guard<std::mutex> lockGuard(snapshotLock);
+	currentSnapshot = snapshot;
+	return snapshot;
+}
 
-	std::string data = ss.str();
-	output->addBytes(data.c_str(), data.size());
+// network thread, returns the last snapshot even if it expired and queues a
+// rebuild on the dispatcher, nullptr until the first one was built
+std::shared_ptr<const StatusSnapshot> getSnapshot() {
+	std::lock_guard<std::mutex> lockGuard(snapshotLock);
+	if (currentSnapshot && !snapshotRefreshQueued && isSnapshotExpired(*currentSnapshot)) {
+		snapshotRefreshQueued = true;
+		g_dispatcher.addTask(refreshSnapshot);
+	}
+	return currentSnapshot;
+}
+
+}
+
+std::size_t ProtocolStatus::AddressHash::operator()(const Connection::Address& address) const {
+	if (address.is_v4()) {
+		return std::hash<uint32_t>{}(address.to_v4().to_uint());
+	}
+
+	const auto bytes = address.to_v6().to_bytes();
+	return std::hash<std::string_view>{}({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+}
+
+void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg) {
+	const static auto acceptorAddress = boost::asio::ip::make_address(getString(ConfigManager::IP));
+
+	const auto& ip = getIP();
+	const int64_t now = OTSYS_TIME();
+	const int64_t timeout = getNumber(ConfigManager::STATUSQUERY_TIMEOUT);
+
+	if (!ip.is_loopback() && ip != acceptorAddress) {
+		if (auto it = ipConnectMap.find(ip); it != ipConnectMap.end() && now < (it->second + timeout)) {
+			disconnect();
+			return;
+		}
+	}
+
+	// addresses that may query again are of no use anymore
+	if (now >= ipConnectMapPurgeTime) {
+		std::erase_if(ipConnectMap, [=](const auto& it) { return now >= it.second + timeout; });
+		ipConnectMapPurgeTime = now + timeout;
+	}
+
+	ipConnectMap[ip] = now;
+
+	switch (msg.getByte()) {
+		//XML info protocol
+		case 0xFF: {
+			if (msg.getString(4) == "info") {
+				if (const auto& snapshot = getSnapshot()) {
+					sendStatusString(*snapshot);
+					return;
+				}
+
+				g_dispatcher.addTask([thisPtr = std::static_pointer_cast<ProtocolStatus>(shared_from_this())]() {
+					thisPtr->sendStatusString(*refreshSnapshot());
+				});
+				return;
+			}
+			break;
+		}
+
+		//Another ServerInfo protocol
+		case 0x01: {
+			uint16_t requestedInfo = msg.get<uint16_t>(); // only a Byte is necessary, though we could add new info here
+			std::string characterName;
+			if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
+				characterName = msg.getString();
+			}
+
+			if ((requestedInfo & LIVE_INFO_SECTIONS) == 0) {
+				if (const auto& snapshot = getSnapshot()) {
+					sendInfo(requestedInfo, characterName, *snapshot);
+					return;
+				}
+			}
+
+			g_dispatcher.addTask([=, thisPtr = std::static_pointer_cast<ProtocolStatus>(shared_from_this()), characterName = std::move(characterName)]() {
+					thisPtr->sendInfo(requestedInfo, characterName, *refreshSnapshot());
+			});
+			return;
+		}
+
+		default:
+			break;
+	}
+	disconnect();
+}
+
+void ProtocolStatus::sendStatusString(const StatusSnapshot& snapshot) {
+	auto output = net::make_output_message();
+
+	setRawMessages(true);
+
+	output->addBytes(snapshot.statusString.data(), snapshot.statusString.size());
 	send(output);
 	disconnect();
 }
 
-void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string& characterName) {
+void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string& characterName, const StatusSnapshot& snapshot) {
 	auto output = net::make_output_message();
 
+	auto addSection = [&](size_t index) {
+		const std::string& section = snapshot.infoSections[index];
+		output->addBytes(section.data(), section.size());
+	};
+
 	if (requestedInfo & REQUEST_BASIC_SERVER_INFO) {
-		output->addByte(0x10);
-		output->addString(getString(ConfigManager::SERVER_NAME));
-		output->addString(getString(ConfigManager::IP));
-		output->addString(std::to_string(getNumber(ConfigManager::LOGIN_PORT)));
+		addSection(0);
 	}
 
 	if (requestedInfo & REQUEST_OWNER_SERVER_INFO) {
-		output->addByte(0x11);
-		output->addString(getString(ConfigManager::OWNER_NAME));
-		output->addString(getString(ConfigManager::OWNER_EMAIL));
+		addSection(1);
 	}
 
 	if (requestedInfo & REQUEST_MISC_SERVER_INFO) {
-		output->addByte(0x12);
-		output->addString(getString(ConfigManager::MOTD));
-		output->addString(getString(ConfigManager::LOCATION));
-		output->addString(getString(ConfigManager::URL));
+		addSection(2);
 		output->add<uint64_t>((OTSYS_TIME() - ProtocolStatus::start) / 1000);
 	}
 
 	if (requestedInfo & REQUEST_PLAYERS_INFO) {
-		output->addByte(0x20);
-		output->add<uint32_t>(g_game.getPlayersOnline());
-		output->add<uint32_t>(getNumber(ConfigManager::MAX_PLAYERS));
-		output->add<uint32_t>(g_game.getPlayersRecord());
+		addSection(3);
 	}
 
 	if (requestedInfo & REQUEST_MAP_INFO) {
-		output->addByte(0x30);
-		output->addString(getString(ConfigManager::MAP_NAME));
-		output->addString(getString(ConfigManager::MAP_AUTHOR));
-		uint32_t mapWidth, mapHeight;
-		g_game.getMapDimensions(mapWidth, mapHeight);
-		output->add<uint16_t>(mapWidth);
-		output->add<uint16_t>(mapHeight);
+		addSection(4);
 	}
 
 	if (requestedInfo & REQUEST_EXT_PLAYERS_INFO) {
@@ -202,11 +333,8 @@ void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string& charact
 	}
 
 	if (requestedInfo & REQUEST_SERVER_SOFTWARE_INFO) {
-		output->addByte(0x23); // server software info
-		output->addString(STATUS_SERVER_NAME);
-		output->addString(STATUS_SERVER_VERSION);
-		output->addString(CLIENT_VERSION_STR);
+		addSection(7);
 	}
 	send(output);
 	disconnect();
-}
\ No newline at end of file
+}
@@ -8,6 +8,15 @@
 
 class NetworkMessage;
 
+// status responses encoded on the dispatcher, the network thread serves them
+// as they are until they are older than statusCacheTime
+struct StatusSnapshot {
+	int64_t createdAt = 0;
+	std::string statusString;
+	// pre-encoded sections of the info protocol, by bit of the requested info
+	std::array<std::string, 8> infoSections;
+};
+
 class ProtocolStatus final : public Protocol {
 	public:
 		// static protocol information
@@ -22,13 +31,18 @@ class ProtocolStatus final : public Protocol {
 
 		void onRecvFirstMessage(NetworkMessage& msg) override;
 
-		void sendStatusString();
-		void sendInfo(uint16_t requestedInfo, const std::string& characterName);
+		void sendStatusString(const StatusSnapshot& snapshot);
+		void sendInfo(uint16_t requestedInfo, const std::string& characterName, const StatusSnapshot& snapshot);
 
 		static const uint64_t start;
 
 	private:
-		static std::map<Connection::Address, int64_t> ipConnectMap;
+		struct AddressHash {
+			std::size_t operator()(const Connection::Address& address) const;
+		};
+
+		static std::unordered_map<Connection::Address, int64_t, AddressHash> ipConnectMap;
+		static int64_t ipConnectMapPurgeTime;
 };
 
-#endif // FS_PROTOCOLSTATUS_H
\ No newline at end of file
+#endif // FS_PROTOCOLSTATUS_H
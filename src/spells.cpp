@@ -88,6 +88,11 @@ void Spells::clearMaps(bool fromLua) {
 		}
 	}
 
+	instantWords.clear();
+	for (auto& it : instants) {
+		instantWords.insert(it.first, &it.second);
+	}
+
 	for (auto rune = runes.begin(); rune != runes.end();) {
 		if (fromLua == rune->second.fromLua) {
 			rune = runes.erase(rune);
@@ -122,8 +127,11 @@ bool Spells::registerEvent(Event_ptr event, const pugi::xml_node&) {
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
 		if (!result.second) {
 			std::cout << "[Warning - Spells::registerEvent] Duplicate registered instant spell with words: " << instant->getWords() << std::endl;
+			return false;
 		}
-		return result.second;
+
+		instantWords.insert(result.first->first, &result.first->second);
+		return true;
 	}
 
 	RuneSpell* rune = dynamic_cast<RuneSpell*>(event.get());
@@ -145,8 +153,11 @@ bool Spells::registerInstantLuaEvent(InstantSpell* event) {
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
 		if (!result.second) {
 			std::cout << "[Warning - Spells::registerInstantLuaEvent] Duplicate registered instant spell with words: " << words << std::endl;
+			return false;
 		}
-		return result.second;
+
+		instantWords.insert(words, &result.first->second);
+		return true;
 	}
 
 	return false;
@@ -196,38 +207,24 @@ RuneSpell* Spells::getRuneSpellByName(const std::string& name) {
 	return nullptr;
 }
 
-InstantSpell* Spells::getInstantSpell(const std::string& words) {
-	InstantSpell* result = nullptr;
-
-	for (auto& it : instants) {
-		const std::string& instantSpellWords = it.second.getWords();
-		size_t spellLen = instantSpellWords.length();
-		if (caseInsensitiveStartsWith(words, instantSpellWords)) {
-			if (!result || spellLen > result->getWords().size()) {
-				result = &it.second;
-				if (words.length() == spellLen) {
-					break;
-				}
-			}
-		}
+InstantSpell* Spells::getInstantSpell(std::string_view words) {
+	InstantSpell* result = instantWords.findLongestPrefix(words);
+	if (!result) {
+		return nullptr;
 	}
 
-	if (result) {
-		const std::string& resultWords = result->getWords();
-		if (words.length() > resultWords.length()) {
-			if (!result->getHasParam()) {
-				return nullptr;
-			}
+	const size_t spellLen = result->getWords().length();
+	if (words.length() > spellLen) {
+		if (!result->getHasParam()) {
+			return nullptr;
+		}
 
-			size_t spellLen = resultWords.length();
-			size_t paramLen = words.length() - spellLen;
-			if (paramLen < 2 || words[spellLen] != ' ') {
-				return nullptr;
-			}
+		size_t paramLen = words.length() - spellLen;
+		if (paramLen < 2 || words[spellLen] != ' ') {
+			return nullptr;
 		}
-		return result;
 	}
-	return nullptr;
+	return result;
 }
 
 InstantSpell* Spells::getInstantSpellByName(const std::string& name) {
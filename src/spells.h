@@ -10,6 +10,7 @@
 #include "luascript.h"
 #include "talkaction.h"
 #include "vocation.h"
+#include "wordtree.h"
 
 class InstantSpell;
 class RuneSpell;
@@ -33,7 +34,7 @@ class Spells final : public BaseEvents {
 		RuneSpell* getRuneSpell(uint32_t id);
 		RuneSpell* getRuneSpellByName(const std::string& name);
 
-		InstantSpell* getInstantSpell(const std::string& words);
+		InstantSpell* getInstantSpell(std::string_view words);
 		InstantSpell* getInstantSpellByName(const std::string& name);
 
 		TalkActionResult_t playerSaySpell(Player* player, std::string& words);
@@ -59,6 +60,7 @@ class Spells final : public BaseEvents {
 
 		std::map<uint16_t, RuneSpell> runes;
 		std::map<std::string, InstantSpell> instants;
+		WordTree<InstantSpell> instantWords;
 
 		friend class CombatSpell;
 		LuaScriptInterface scriptInterface { "Spell Interface" };
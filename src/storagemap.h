@@ -0,0 +1,164 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_STORAGEMAP_H
+#define FS_STORAGEMAP_H
+
+/**
+ * Open addressing hash map from storage keys to their values.
+ * The entries sit in one flat array probed linearly, so a lookup usually reads a
+ * single cache line even for players that carry thousands of keys.
+ */
+class StorageMap {
+	public:
+		using value_type = std::pair<uint32_t, int32_t>;
+
+		class const_iterator {
+			public:
+				const_iterator(const StorageMap& map, size_t index) : map(&map), index(index) {
+					skipUnused();
+				}
+
+				const value_type& operator*() const {
+					return map->entries[index];
+				}
+				const value_type* operator->() const {
+					return &map->entries[index];
+				}
+
+				const_iterator& operator++() {
+					++index;
+					skipUnused();
+					return *this;
+				}
+
+				bool operator==(const const_iterator& other) const {
+					return index == other.index;
+				}
+				bool operator!=(const const_iterator& other) const {
+					return index != other.index;
+				}
+
+			private:
+				void skipUnused() {
+					while (index < map->used.size() && !map->used[index]) {
+						++index;
+					}
+				}
+
+				const StorageMap* map;
+				size_t index;
+		};
+
+		std::optional<int32_t> get(uint32_t key) const {
+			if (count == 0) {
+				return std::nullopt;
+			}
+
+			for (size_t index = getBucket(key); used[index]; index = (index + 1) & mask()) {
+				if (entries[index].first == key) {
+					return entries[index].second;
+				}
+			}
+			return std::nullopt;
+		}
+
+		void set(uint32_t key, int32_t value) {
+			// keep the load factor below 3/4 so probe chains stay short
+			if ((count + 1) * 4 > entries.size() * 3) {
+				rehash(std::max<size_t>(entries.size() * 2, 16));
+			}
+
+			size_t index = getBucket(key);
+			for (; used[index]; index = (index + 1) & mask()) {
+				if (entries[index].first == key) {
+					entries[index].second = value;
+					return;
+				}
+			}
+
+			entries[index] = {key, value};
+			used[index] = 1;
+			++count;
+		}
+
+		bool erase(uint32_t key) {
+			if (count == 0) {
+				return false;
+			}
+
+			size_t index = getBucket(key);
+			for (; used[index]; index = (index + 1) & mask()) {
+				if (entries[index].first == key) {
+					break;
+				}
+			}
+
+			if (!used[index]) {
+				return false;
+			}
+
+			// shift the following entries of the probe chain back instead of leaving a tombstone
+			for (size_t next = (index + 1) & mask(); used[next]; next = (next + 1) & mask()) {
+				const size_t bucket = getBucket(entries[next].first);
+				if (((next - bucket) & mask()) >= ((next - index) & mask())) {
+					entries[index] = entries[next];
+					index = next;
+				}
+			}
+
+			used[index] = 0;
+			--count;
+			return true;
+		}
+
+		void clear() {
+			entries.clear();
+			used.clear();
+			count = 0;
+		}
+
+		size_t size() const {
+			return count;
+		}
+		bool empty() const {
+			return count == 0;
+		}
+
+		const_iterator begin() const {
+			return {*this, 0};
+		}
+		const_iterator end() const {
+			return {*this, used.size()};
+		}
+
+	private:
+		size_t mask() const {
+			return entries.size() - 1;
+		}
+
+		size_t getBucket(uint32_t key) const {
+			// fibonacci hashing spreads the sequential keys scripts like to use
+			return ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask();
+		}
+
+		void rehash(size_t capacity) {
+			std::vector<value_type> oldEntries(capacity);
+			std::vector<uint8_t> oldUsed(capacity);
+			entries.swap(oldEntries);
+			used.swap(oldUsed);
+			count = 0;
+
+			for (size_t i = 0, size = oldEntries.size(); i < size; ++i) {
+				if (oldUsed[i]) {
+					set(oldEntries[i].first, oldEntries[i].second);
+				}
+			}
+		}
+
+		std::vector<value_type> entries;
+		std::vector<uint8_t> used;
+		size_t count = 0;
+};
+
+#endif // FS_STORAGEMAP_H
@@ -24,6 +24,11 @@ void TalkActions::clear(bool fromLua) {
 		}
 	}
 
+	talkActionWords.clear();
+	for (const auto& it : talkActions) {
+		talkActionWords.insert(it.first, &it);
+	}
+
 	reInitState(fromLua);
 }
 
@@ -44,9 +49,9 @@ bool TalkActions::registerEvent(Event_ptr event, const pugi::xml_node&) {
 
 	for (size_t i = 0; i < words.size(); i++) {
 		if (i == words.size() - 1) {
-			talkActions.emplace(words[i], std::move(*talkAction));
+			addTalkAction(words[i], std::move(*talkAction));
 		} else {
-			talkActions.emplace(words[i], *talkAction);
+			addTalkAction(words[i], *talkAction);
 		}
 	}
 
@@ -59,63 +64,74 @@ bool TalkActions::registerLuaEvent(TalkAction* event) {
 
 	for (size_t i = 0; i < words.size(); i++) {
 		if (i == words.size() - 1) {
-			talkActions.emplace(words[i], std::move(*talkAction));
+			addTalkAction(words[i], std::move(*talkAction));
 		} else {
-			talkActions.emplace(words[i], *talkAction);
+			addTalkAction(words[i], *talkAction);
 		}
 	}
 
 	return true;
 }
 
+void TalkActions::addTalkAction(const std::string& words, TalkAction talkAction) {
+	auto result = talkActions.emplace(words, std::move(talkAction));
+	if (result.second) {
+		talkActionWords.insert(words, &*result.first);
+	}
+}
+
 TalkActionResult_t TalkActions::playerSaySpell(Player* player, SpeakClasses type, const std::string& words) const {
-	size_t wordsLength = words.length();
-	for (auto it = talkActions.begin(); it != talkActions.end();) {
-		const std::string& talkactionWords = it->first;
-		if (!caseInsensitiveStartsWith(words, talkactionWords)) {
-			++it;
-			continue;
+	const TalkActionMap::value_type* match = nullptr;
+	std::string param;
+
+	// the words said must be followed by nothing or a space, if several match the shortest one wins
+	talkActionWords.visitPrefixes(words, [&](const TalkActionMap::value_type* candidate, size_t length) {
+		if (length == words.size()) {
+			param.clear();
+			match = candidate;
+			return true;
 		}
 
-		std::string param;
-		if (wordsLength != talkactionWords.size()) {
-			param = words.substr(talkactionWords.size());
-			if (param.front() != ' ') {
-				++it;
-				continue;
-			}
-			boost::algorithm::trim_left(param);
-
-			std::string separator = it->second.getSeparator();
-			if (separator != " ") {
-				if (!param.empty()) {
-					if (param != separator) {
-						++it;
-						continue;
-					} else {
-						param.erase(param.begin());
-					}
-				}
-			}
+		if (words[length] != ' ') {
+			return false;
 		}
 
-		if (it->second.fromLua) {
-			if (it->second.getNeedAccess() && !player->getGroup()->access) {
-				return TALKACTION_CONTINUE;
-			}
+		param = words.substr(length);
+		boost::algorithm::trim_left(param);
 
-			if (player->getAccountType() < it->second.getRequiredAccountType()) {
-				return TALKACTION_CONTINUE;
+		const std::string& separator = candidate->second.getSeparator();
+		if (separator != " " && !param.empty()) {
+			if (param != separator) {
+				return false;
 			}
+			param.erase(param.begin());
 		}
 
-		if (it->second.executeSay(player, talkactionWords, param, type)) {
+		match = candidate;
+		return true;
+	});
+
+	if (!match) {
+		return TALKACTION_CONTINUE;
+	}
+
+	const auto& [talkactionWords, talkAction] = *match;
+
+	if (talkAction.fromLua) {
+		if (talkAction.getNeedAccess() && !player->getGroup()->access) {
 			return TALKACTION_CONTINUE;
-		} else {
-			return TALKACTION_BREAK;
 		}
+
+		if (player->getAccountType() < talkAction.getRequiredAccountType()) {
+			return TALKACTION_CONTINUE;
+		}
+	}
+
+	if (talkAction.executeSay(player, talkactionWords, param, type)) {
+		return TALKACTION_CONTINUE;
+	} else {
+		return TALKACTION_BREAK;
 	}
-	return TALKACTION_CONTINUE;
 }
 
 bool TalkAction::configureEvent(const pugi::xml_node& node) {
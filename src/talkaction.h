@@ -7,6 +7,7 @@
 #include "baseevents.h"
 #include "const.h"
 #include "luascript.h"
+#include "wordtree.h"
 
 class TalkAction;
 
@@ -34,7 +35,7 @@ class TalkAction : public Event {
 			words = word;
 			wordsMap.emplace_back(word);
 		}
-		std::string getSeparator() const {
+		const std::string& getSeparator() const {
 			return separator;
 		}
 		void setSeparator(std::string sep) {
@@ -94,7 +95,12 @@ class TalkActions final : public BaseEvents {
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
-		std::map<std::string, TalkAction> talkActions;
+		using TalkActionMap = std::map<std::string, TalkAction>;
+
+		void addTalkAction(const std::string& words, TalkAction talkAction);
+
+		TalkActionMap talkActions;
+		WordTree<const TalkActionMap::value_type> talkActionWords;
 
 		LuaScriptInterface scriptInterface;
 };
@@ -9,6 +9,7 @@
 #include "configmanager.h"
 #include "creature.h"
 #include "game.h"
+#include "house.h"
 #include "housetile.h"
 #include "mailbox.h"
 #include "monster.h"
@@ -23,6 +24,47 @@ extern MoveEvents* g_moveEvents;
 StaticTile real_nullptr_tile(0xFFFF, 0xFFFF, 0xFF);
 Tile& Tile::nullptr_tile = real_nullptr_tile;
 
+namespace {
+
+// tiles holding an items encoding, the most recently described one first, never
+// destroyed as the map may release its tiles after the static destructors ran
+std::list<const Tile*>& encodedTiles = *new std::list<const Tile*>();
+
+using TileItemEncoder = void (*)(NetworkMessage&, const Position&, uint32_t, const Item*);
+
+// the item looks the same to every spectator, only the stack position differs for
+// those who can't see a creature on the tile, so it is re-encoded only then
+void sendTileItem(const SpectatorVec& spectators, const Tile* tile, const Position& pos, const Item* item, TileItemEncoder encode) {
+	NetworkMessage msg;
+	int32_t encodedStackpos = -1;
+	uint64_t receivers = 0, encodes = 0;
+	for (Creature* spectator : spectators) {
+		Player* spectatorPlayer = spectator->getPlayer();
+		if (!spectatorPlayer || !spectatorPlayer->canSee(pos)) {
+			continue;
+		}
+
+		const int32_t stackpos = tile->getStackposOfItem(spectatorPlayer, item);
+		if (stackpos == -1) {
+			continue;
+		}
+
+		if (stackpos != encodedStackpos) {
+			msg.reset();
+			encode(msg, pos, stackpos, item);
+			encodedStackpos = stackpos;
+			++encodes;
+		}
+
+		spectatorPlayer->sendNetworkMessage(msg);
+		++receivers;
+	}
+
+	Game::broadcastEncodesSaved += receivers - encodes;
+}
+
+}
+
 bool Tile::hasProperty(ITEMPROPERTY prop) const {
 	if (ground && ground->hasProperty(prop)) {
 		return true;
@@ -341,11 +383,7 @@ void Tile::onAddTileItem(Item* item) {
 	g_game.map.getSpectators(spectators, cylinderMapPos, true);
 
 	//send to client
-	for (Creature* spectator : spectators) {
-		if (Player* spectatorPlayer = spectator->getPlayer()) {
-			spectatorPlayer->sendAddTileItem(this, cylinderMapPos, item);
-		}
-	}
+	sendTileItem(spectators, this, cylinderMapPos, item, ProtocolGame::AddTileItem);
 
 	//event methods
 	for (Creature* spectator : spectators) {
@@ -384,11 +422,7 @@ void Tile::onUpdateTileItem(Item* oldItem, const ItemType& oldType, Item* newIte
 	g_game.map.getSpectators(spectators, cylinderMapPos, true);
 
 	//send to client
-	for (Creature* spectator : spectators) {
-		if (Player* spectatorPlayer = spectator->getPlayer()) {
-			spectatorPlayer->sendUpdateTileItem(this, cylinderMapPos, newItem);
-		}
-	}
+	sendTileItem(spectators, this, cylinderMapPos, newItem, ProtocolGame::UpdateTileItem);
 
 	//event methods
 	for (Creature* spectator : spectators) {
@@ -830,6 +864,7 @@ void Tile::addThing(int32_t, Thing* thing) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
 
+		onItemsChanged();
 		item->setParent(this);
 
 		const ItemType& itemType = Item::items[item->getID()];
@@ -930,6 +965,8 @@ void Tile::updateThing(Thing* thing, uint16_t itemId, uint32_t count) {
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	onItemsChanged();
+
 	const ItemType& oldType = Item::items[item->getID()];
 	const ItemType& newType = Item::items[itemId];
 	resetTileFlags(item);
@@ -947,6 +984,8 @@ void Tile::replaceThing(uint32_t index, Thing* thing) {
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	onItemsChanged();
+
 	Item* oldItem = nullptr;
 	bool isInserted = false;
 
@@ -1038,6 +1077,8 @@ void Tile::removeThing(Thing* thing, uint32_t count) {
 		return;
 	}
 
+	onItemsChanged();
+
 	if (item == ground) {
 		ground->setParent(nullptr);
 		ground = nullptr;
@@ -1111,7 +1152,7 @@ bool Tile::hasCreature(Creature* creature) const
 }
 
 void Tile::removeCreature(Creature* creature) {
-	g_game.map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature);
+	g_game.map.creatureIndex.removeCreature(creature);
 	removeThing(creature, 0);
 }
 
@@ -1399,6 +1440,8 @@ void Tile::internalAddThing(uint32_t, Thing* thing) {
 			return;
 		}
 
+		onItemsChanged();
+
 		const ItemType& itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
 			if (!ground) {
@@ -1435,6 +1478,40 @@ void Tile::internalAddThing(uint32_t, Thing* thing) {
 	}
 }
 
+const TileItemsEncoding* Tile::getItemsEncoding() const {
+	if (itemsEncoding) {
+		encodedTiles.splice(encodedTiles.begin(), encodedTiles, itemsEncoding->lruPosition);
+	}
+	return itemsEncoding.get();
+}
+
+const TileItemsEncoding& Tile::setItemsEncoding(std::unique_ptr<TileItemsEncoding> encoding) const {
+	resetItemsEncoding();
+
+	if (encodedTiles.size() >= MAX_ITEMS_ENCODINGS) {
+		encodedTiles.back()->resetItemsEncoding();
+	}
+
+	itemsEncoding = std::move(encoding);
+	itemsEncoding->lruPosition = encodedTiles.insert(encodedTiles.begin(), this);
+	return *itemsEncoding;
+}
+
+void Tile::resetItemsEncoding() const {
+	if (itemsEncoding) {
+		encodedTiles.erase(itemsEncoding->lruPosition);
+		itemsEncoding.reset();
+	}
+}
+
+void Tile::onItemsChanged() {
+	resetItemsEncoding();
+
+	if (House* house = getHouse()) {
+		house->setItemsChanged();
+	}
+}
+
 void Tile::setTileFlags(const Item* item) {
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		const ItemType& it = Item::items[item->getID()];
@@ -1491,6 +1568,10 @@ void Tile::setTileFlags(const Item* item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		g_game.map.onSightChanged();
+	}
 }
 
 void Tile::resetTileFlags(const Item* item) {
@@ -1551,6 +1632,10 @@ void Tile::resetTileFlags(const Item* item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		g_game.map.onSightChanged();
+	}
 }
 
 bool Tile::isMoveableBlocking() const {
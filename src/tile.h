@@ -10,15 +10,28 @@
 
 class BedItem;
 class Creature;
+class House;
 class MagicField;
 class Mailbox;
 class SpectatorVec;
 class Teleport;
+class Tile;
 class TrashHolder;
 
 using CreatureVector = std::vector<Creature*>;
 using ItemVector = std::vector<Item*>;
 
+// client encoding of the items of a tile, built by ProtocolGame when the tile
+// is described and dropped whenever the items of the tile change
+struct TileItemsEncoding {
+	std::string topItems; // environmental effects, ground and top items
+	std::string downItems;
+	std::vector<uint16_t> downItemEnds; // end of each down item in downItems
+	int32_t topItemCount = 0;
+
+	std::list<const Tile*>::iterator lruPosition;
+};
+
 enum tileflags_t : uint32_t {
 	TILESTATE_NONE = 0,
 
@@ -133,6 +146,7 @@ class Tile : public Cylinder {
 		static Tile& nullptr_tile;
 		Tile(uint16_t x, uint16_t y, uint8_t z) : tilePos(x, y, z) {}
 		virtual ~Tile() {
+			resetItemsEncoding();
 			delete ground;
 		};
 
@@ -264,8 +278,20 @@ class Tile : public Cylinder {
 		}
 		void setGround(Item* item) {
 			ground = item;
+			resetItemsEncoding();
+		}
+
+		virtual House* getHouse() const {
+			return nullptr;
 		}
 
+		// only the encodings of the most recently described tiles are kept
+		static constexpr size_t MAX_ITEMS_ENCODINGS = 1 << 17;
+
+		const TileItemsEncoding* getItemsEncoding() const;
+		const TileItemsEncoding& setItemsEncoding(std::unique_ptr<TileItemsEncoding> encoding) const;
+		void resetItemsEncoding() const;
+
 	private:
 		void onAddTileItem(Item* item);
 		void onUpdateTileItem(Item* oldItem, const ItemType& oldType, Item* newItem, const ItemType& newType);
@@ -275,7 +301,10 @@ class Tile : public Cylinder {
 		void setTileFlags(const Item* item);
 		void resetTileFlags(const Item* item);
 
+		void onItemsChanged();
+
 		Item* ground = nullptr;
+		mutable std::unique_ptr<TileItemsEncoding> itemsEncoding;
 		Position tilePos;
 		uint32_t flags = 0;
 };
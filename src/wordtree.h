@@ -0,0 +1,96 @@
+// Copyright 2023 The Forgotten Server Authors. All rights reserved.
+// Use of this source code is governed by the GPL-2.0 License that can be found in the LICENSE file.
+
+#ifndef FS_WORDTREE_H
+#define FS_WORDTREE_H
+
+/**
+ * Case-insensitive prefix tree over spell and talkaction words.
+ * A lookup walks the said text once and reports every registered word that
+ * prefixes it, shortest first, without copying or allocating.
+ */
+template <typename T>
+class WordTree {
+	public:
+		WordTree() {
+			clear();
+		}
+
+		// non-copyable
+		WordTree(const WordTree&) = delete;
+		WordTree& operator=(const WordTree&) = delete;
+
+		// keeps the value of a word that is already registered, like std::map::emplace
+		void insert(std::string_view words, T* value) {
+			uint32_t index = 0;
+			for (char ch : words) {
+				const uint32_t child = getChild(index, fold(ch));
+				if (child != 0) {
+					index = child;
+					continue;
+				}
+
+				nodes[index].children.emplace_back(fold(ch), static_cast<uint32_t>(nodes.size()));
+				index = nodes.size();
+				nodes.emplace_back();
+			}
+
+			if (!nodes[index].value) {
+				nodes[index].value = value;
+			}
+		}
+
+		void clear() {
+			nodes.clear();
+			nodes.emplace_back();
+		}
+
+		// calls visitor(value, length) for every word that prefixes text, stops once it returns true
+		template <typename Visitor>
+		void visitPrefixes(std::string_view text, Visitor&& visitor) const {
+			uint32_t index = 0;
+			for (size_t length = 0, size = text.size(); length < size; ++length) {
+				index = getChild(index, fold(text[length]));
+				if (index == 0) {
+					return;
+				}
+
+				if (T* value = nodes[index].value; value && visitor(value, length + 1)) {
+					return;
+				}
+			}
+		}
+
+		T* findLongestPrefix(std::string_view text) const {
+			T* result = nullptr;
+			visitPrefixes(text, [&result](T* value, size_t) {
+				result = value;
+				return false;
+			});
+			return result;
+		}
+
+	private:
+		struct Node {
+			std::vector<std::pair<char, uint32_t>> children;
+			T* value = nullptr;
+		};
+
+		static char fold(char ch) {
+			return tolower(ch);
+		}
+
+		// the root is never a child, so 0 doubles as "no child"
+		uint32_t getChild(uint32_t index, char ch) const {
+			for (const auto& [childCh, childIndex] : nodes[index].children) {
+				if (childCh == ch) {
+					return childIndex;
+				}
+			}
+			return 0;
+		}
+
+		std::vector<Node> nodes;
+};
+
+#endif // FS_WORDTREE_H